@@ -0,0 +1,138 @@
+#include "../Source/DSP/DriveStage.h"
+#include "Benchmark.h"
+
+namespace {
+using StereoVec = ADAAShaper::StereoVec;
+
+constexpr float drive = 7.0f;
+
+// applyDistortion as DriveStage runs it without ADAA: a full SIMD register
+// at a time
+void processDirect(juce::AudioBuffer<float> &buffer) {
+  using Vec = xsimd::batch<float>;
+  constexpr auto laneCount = (int)Vec::size;
+
+  for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+    auto *data = buffer.getWritePointer(ch);
+    const auto numSamples = buffer.getNumSamples();
+
+    int i = 0;
+    for (; i + laneCount <= numSamples; i += laneCount)
+      applyDistortion(Vec::load_unaligned(data + i), drive)
+          .store_unaligned(data + i);
+
+    for (; i < numSamples; ++i)
+      data[i] = applyDistortion(data[i], drive);
+  }
+}
+
+// The normalised curve read from a table instead of computed
+class TableCurve {
+public:
+  TableCurve() {
+    table.initialise(StrangerCurve::shape<float>, -range, range, 1 << 14);
+  }
+
+  void process(juce::AudioBuffer<float> &buffer) const {
+    const auto in = (float)StrangerCurve::inputScale(drive);
+    const auto out = (float)StrangerCurve::outputScale(drive);
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+      auto *data = buffer.getWritePointer(ch);
+      const auto numSamples = buffer.getNumSamples();
+
+      juce::FloatVectorOperations::multiply(data, in, numSamples);
+      table.process(data, data, numSamples);
+      juce::FloatVectorOperations::multiply(data, out, numSamples);
+    }
+  }
+
+private:
+  static constexpr float range = 16.0f;
+  chowdsp::LookupTableTransform<float> table;
+};
+
+// First-order ADAA with the closed-form antiderivative, one double log1p
+// per sample: ADAAShaper::processFirstOrder before the table
+class ClosedFormADAA {
+public:
+  void process(juce::AudioBuffer<float> &buffer) {
+    using namespace StrangerCurve;
+
+    auto *left = buffer.getWritePointer(0);
+    auto *right = buffer.getWritePointer(1);
+    const StereoVec in(inputScale(drive)), out(outputScale(drive));
+    const StereoVec half(0.5), tolerance(1.0e-5);
+
+    for (int i = 0; i < buffer.getNumSamples(); ++i) {
+      const auto x = in * StereoVec((double)left[i], (double)right[i]);
+      const auto ad1_x0 = shapeAD1(x);
+      const auto dx = x - x1;
+
+      const auto slope = (ad1_x0 - ad1_x1) / dx;
+      const auto nearlyEqual = xsimd::abs(dx) < tolerance;
+      const auto y =
+          out * (xsimd::any(nearlyEqual)
+                     ? xsimd::select(nearlyEqual, shape(half * (x + x1)), slope)
+                     : slope);
+
+      left[i] = (float)y.get(0);
+      right[i] = (float)y.get(1);
+      x1 = x;
+      ad1_x1 = ad1_x0;
+    }
+  }
+
+private:
+  StereoVec x1{0.0}, ad1_x1{0.0};
+};
+} // namespace
+
+void Benchmark::runADAABenchmarks() {
+  std::printf("Drive curve: direct, table and first-order ADAA, per host "
+              "block at the oversampled rate\n");
+
+  for (const int factor : {4, 8}) {
+    const auto numSamples = blockSize * factor;
+    juce::AudioBuffer<float> input(2, numSamples), direct(2, numSamples),
+        tabled(2, numSamples), closedForm(2, numSamples),
+        adaaTabled(2, numSamples);
+    fillNoise(input);
+
+    TableCurve tableCurve;
+    ClosedFormADAA closedFormADAA;
+    ADAAShaper shaper;
+    shaper.setDrive(drive);
+
+    // Fresh input every call, as the oversampler would hand over
+    const auto directMicros = microsecondsPerCall([&] {
+      direct.makeCopyOf(input, true);
+      processDirect(direct);
+    });
+    const auto tableMicros = microsecondsPerCall([&] {
+      tabled.makeCopyOf(input, true);
+      tableCurve.process(tabled);
+    });
+    const auto closedFormMicros = microsecondsPerCall([&] {
+      closedForm.makeCopyOf(input, true);
+      closedFormADAA.process(closedForm);
+    });
+    const auto adaaTableMicros = microsecondsPerCall([&] {
+      adaaTabled.makeCopyOf(input, true);
+      shaper.processFirstOrder(adaaTabled.getArrayOfWritePointers(), 2,
+                               numSamples);
+    });
+
+    // Both ADAA paths have run the same number of blocks, so their
+    // histories line up
+    std::printf(" %dx (table curve against direct %.2g, table ADAA against "
+                "closed form %.2g)\n",
+                factor, getMaxDifference(direct, tabled),
+                getMaxDifference(closedForm, adaaTabled));
+    report("direct applyDistortion", directMicros, directMicros);
+    report("table curve", tableMicros, directMicros);
+    report("first-order ADAA, closed form", closedFormMicros, directMicros);
+    report("first-order ADAA, table", adaaTableMicros, directMicros);
+  }
+  std::printf("\n");
+}
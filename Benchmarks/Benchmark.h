@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+//==============================================================================
+/**
+ * Minimal timing helpers for the DSP benchmarks. Each benchmark file defines
+ * one run...() function, called in turn from BenchmarkMain.cpp.
+ *
+ * Build with -DSTRANGER_AMPS_BENCHMARKS=ON in a Release configuration;
+ * timings from a debug build mean nothing.
+ */
+namespace Benchmark {
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 128;
+
+// Mean time per call in microseconds, the best of several runs
+template <typename Process>
+double microsecondsPerCall(Process &&process, int numCalls = 20000) {
+  using Clock = std::chrono::steady_clock;
+
+  for (int i = 0; i < numCalls / 10; ++i)
+    process();
+
+  auto best = std::numeric_limits<double>::max();
+  for (int run = 0; run < 5; ++run) {
+    const auto start = Clock::now();
+    for (int i = 0; i < numCalls; ++i)
+      process();
+    const std::chrono::duration<double, std::micro> elapsed =
+        Clock::now() - start;
+    best = juce::jmin(best, elapsed.count() / numCalls);
+  }
+  return best;
+}
+
+// Slowest single call in microseconds. The same numCalls calls are replayed
+// from reset() several times and each call keeps its best time, so only
+// the processor's own worst case is left, not the scheduler's.
+template <typename Reset, typename Process>
+double worstMicrosecondsPerCall(Reset &&reset, Process &&process,
+                                int numCalls = 2000) {
+  using Clock = std::chrono::steady_clock;
+
+  std::vector<double> best((size_t)numCalls,
+                           std::numeric_limits<double>::max());
+  for (int run = 0; run < 10; ++run) {
+    reset();
+    for (auto &callBest : best) {
+      const auto start = Clock::now();
+      process();
+      const std::chrono::duration<double, std::micro> elapsed =
+          Clock::now() - start;
+      callBest = juce::jmin(callBest, elapsed.count());
+    }
+  }
+  return *std::max_element(best.begin(), best.end());
+}
+
+// Prints one result line, with the speed-up over the reference
+inline void report(const juce::String &name, double micros,
+                   double referenceMicros) {
+  std::printf("  %-36s %8.3f us/block  %5.2fx\n", name.toRawUTF8(), micros,
+              referenceMicros / micros);
+}
+
+inline void fillNoise(juce::AudioBuffer<float> &buffer, float level = 0.5f) {
+  juce::Random random(1);
+  for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    for (int i = 0; i < buffer.getNumSamples(); ++i)
+      buffer.setSample(ch, i, level * (2.0f * random.nextFloat() - 1.0f));
+}
+
+// Largest sample difference between two buffers of the same size
+inline float getMaxDifference(const juce::AudioBuffer<float> &a,
+                              const juce::AudioBuffer<float> &b) {
+  auto maxDifference = 0.0f;
+  for (int ch = 0; ch < a.getNumChannels(); ++ch)
+    for (int i = 0; i < a.getNumSamples(); ++i)
+      maxDifference = juce::jmax(
+          maxDifference, std::abs(a.getSample(ch, i) - b.getSample(ch, i)));
+  return maxDifference;
+}
+
+void runADAABenchmarks();
+void runBiquadBenchmarks();
+void runSubOctaveBenchmarks();
+} // namespace Benchmark
@@ -0,0 +1,12 @@
+#include "Benchmark.h"
+
+int main() {
+  std::printf("Stranger Amps DSP benchmarks (%d-sample stereo blocks at "
+              "%.0f Hz)\n\n",
+              Benchmark::blockSize, Benchmark::sampleRate);
+
+  Benchmark::runADAABenchmarks();
+  Benchmark::runBiquadBenchmarks();
+  Benchmark::runSubOctaveBenchmarks();
+  return 0;
+}
@@ -0,0 +1,184 @@
+#include "../Source/DSP/BiquadCascade.h"
+#include "Benchmark.h"
+
+namespace {
+using Section = BiquadCascade::Section;
+
+struct ToneStack {
+  const char *name;
+  int numPeq;
+  bool lofi, lowBoost;
+};
+
+// Representative settings for every section
+BiquadCascade::Design getDesign(int section) {
+  switch (section) {
+  case Section::LowBoost:
+    return {BiquadType::LowShelf, 80.0f, 1.0f, 8.0f};
+  case Section::Bass:
+    return {BiquadType::LowShelf, 200.0f, 1.0f, 3.0f};
+  case Section::Mid:
+    return {BiquadType::Peaking, 1000.0f, 1.0f, -4.0f};
+  case Section::Treble:
+    return {BiquadType::HighShelf, 4000.0f, 1.0f, 2.0f};
+  case Section::Presence:
+    return {BiquadType::HighShelf, 6000.0f, 1.0f, 5.0f};
+  case Section::LofiLowPass:
+    return {BiquadType::LowPass, 2000.0f, 0.7f, 0.0f};
+  case Section::LofiHighPass:
+    return {BiquadType::HighPass, 300.0f, 0.7f, 0.0f};
+  default: // PEQ bands
+    return {BiquadType::Peaking, 300.0f * (float)(section - Section::Peq1 + 1),
+            1.0f, 3.0f};
+  }
+}
+
+bool isEnabled(const ToneStack &stack, int section) {
+  if (section == Section::LowBoost)
+    return stack.lowBoost;
+  if (section >= Section::Peq1 && section <= Section::Peq4)
+    return section - Section::Peq1 < stack.numPeq;
+  if (section == Section::LofiLowPass || section == Section::LofiHighPass)
+    return stack.lofi;
+  return true;
+}
+
+// The reference: one juce::dsp::IIR::Filter per section and channel
+struct PerChannelStack {
+  explicit PerChannelStack(const ToneStack &stack) {
+    const juce::dsp::ProcessSpec spec{Benchmark::sampleRate,
+                                      (juce::uint32)Benchmark::blockSize, 1};
+
+    for (int section = 0; section < Section::numSections; ++section) {
+      if (!isEnabled(stack, section))
+        continue;
+
+      const auto d = getDesign(section);
+      const auto c = calculateBiquadCoeffs(d.frequency, d.q, d.gainDB, d.type,
+                                           Benchmark::sampleRate);
+      const juce::dsp::IIR::Coefficients<float>::Ptr coefficients =
+          new juce::dsp::IIR::Coefficients<float>(c.b0, c.b1, c.b2, 1.0f, c.a1,
+                                                  c.a2);
+
+      for (auto &channel : filters) {
+        channel.emplace_back(coefficients);
+        channel.back().prepare(spec);
+      }
+    }
+  }
+
+  void process(juce::dsp::AudioBlock<float> &block) {
+    for (size_t ch = 0; ch < filters.size(); ++ch) {
+      auto channel = block.getSingleChannelBlock(ch);
+      juce::dsp::ProcessContextReplacing<float> context(channel);
+      for (auto &filter : filters[ch])
+        filter.process(context);
+    }
+  }
+
+  std::array<std::vector<juce::dsp::IIR::Filter<float>>, 2> filters;
+};
+
+// BiquadCascade without the fused pass: the same interleaved stereo
+// sections, each making its own pass over the block
+struct PerSectionStack {
+  using StereoVec = BiquadCascade::StereoVec;
+
+  explicit PerSectionStack(const ToneStack &stack)
+      : interleaved((size_t)Benchmark::blockSize) {
+    for (int section = 0; section < Section::numSections; ++section) {
+      if (!isEnabled(stack, section))
+        continue;
+
+      const auto d = getDesign(section);
+      const auto c = calculateBiquadCoeffs(d.frequency, d.q, d.gainDB, d.type,
+                                           Benchmark::sampleRate);
+      const double b[] = {c.b0, c.b1, c.b2};
+      const double a[] = {1.0, c.a1, c.a2};
+
+      auto &filter = filters.emplace_back();
+      for (size_t i = 0; i < 3; ++i) {
+        filter.b[i] = StereoVec(b[i]);
+        filter.a[i] = StereoVec(a[i]);
+      }
+      filter.reset();
+    }
+  }
+
+  void process(juce::dsp::AudioBlock<float> &block) {
+    const auto numSamples = (int)block.getNumSamples();
+    auto *left = block.getChannelPointer(0);
+    auto *right = block.getChannelPointer(1);
+
+    auto *data = interleaved.data();
+    for (int i = 0; i < numSamples; ++i)
+      data[i] = StereoVec((double)left[i], (double)right[i]);
+
+    for (auto &filter : filters)
+      filter.processBlock(data, numSamples);
+
+    for (int i = 0; i < numSamples; ++i) {
+      left[i] = (float)data[i].get(0);
+      right[i] = (float)data[i].get(1);
+    }
+  }
+
+  std::vector<chowdsp::IIRFilter<2, StereoVec>> filters;
+  std::vector<StereoVec> interleaved;
+};
+} // namespace
+
+void Benchmark::runBiquadBenchmarks() {
+  std::printf("Tone stack: BiquadCascade against per-channel "
+              "juce::dsp::IIR::Filter and one pass per section\n");
+
+  const ToneStack stacks[] = {{"tone controls (4 sections)", 0, false, false},
+                              {"+ low boost (5)", 0, false, true},
+                              {"+ PEQ (8)", 4, false, false},
+                              {"everything (11)", 4, true, true}};
+
+  juce::AudioBuffer<float> input(2, blockSize), reference(2, blockSize),
+      perSectionOut(2, blockSize), cascaded(2, blockSize);
+  fillNoise(input);
+
+  for (const auto &stack : stacks) {
+    PerChannelStack perChannel(stack);
+    PerSectionStack perSection(stack);
+
+    BiquadCascade cascade;
+    cascade.prepare(sampleRate, blockSize);
+    for (int section = 0; section < Section::numSections; ++section) {
+      cascade.setDesign((Section)section, getDesign(section));
+      cascade.setEnabled((Section)section, isEnabled(stack, section));
+    }
+
+    juce::dsp::AudioBlock<float> referenceBlock(reference),
+        perSectionBlock(perSectionOut), cascadedBlock(cascaded);
+
+    // Fresh input every call, so the output stays bounded
+    const auto referenceMicros = microsecondsPerCall([&] {
+      reference.makeCopyOf(input, true);
+      perChannel.process(referenceBlock);
+    });
+    const auto perSectionMicros = microsecondsPerCall([&] {
+      perSectionOut.makeCopyOf(input, true);
+      perSection.process(perSectionBlock);
+    });
+    const auto cascadeMicros = microsecondsPerCall([&] {
+      cascaded.makeCopyOf(input, true);
+      cascade.process(cascadedBlock);
+    });
+
+    // All have run the same number of blocks. The fused pass does the same
+    // arithmetic in the same order as one pass per section, so those two
+    // should match exactly.
+    std::printf(" %s (max difference %.2g, fused against unfused %.2g)\n",
+                stack.name, getMaxDifference(reference, cascaded),
+                getMaxDifference(perSectionOut, cascaded));
+    report("juce::dsp::IIR::Filter per channel", referenceMicros,
+           referenceMicros);
+    report("one pass per section", perSectionMicros, referenceMicros);
+    report("BiquadCascade (fused)", cascadeMicros, referenceMicros);
+  }
+  std::printf("\n");
+}
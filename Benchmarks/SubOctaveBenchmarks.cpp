@@ -0,0 +1,190 @@
+#include "../Source/DSP/SubOctave.h"
+#include "Benchmark.h"
+
+namespace {
+// The direct port of the Thicken tracker in amp-processor.js that
+// SubOctave replaced: per channel, per sample, with sin() of an
+// accumulated phase
+class ReferenceSubOctave {
+public:
+  void reset() { state = {}; }
+
+  void process(juce::dsp::AudioBlock<float> &block, float amount) {
+    for (size_t ch = 0; ch < state.size(); ++ch)
+      processChannel(block.getChannelPointer(ch), (int)block.getNumSamples(),
+                     amount, state[ch]);
+  }
+
+private:
+  static constexpr int minPeriod = 40;
+  static constexpr int maxPeriod = 1500;
+
+  struct ChannelState {
+    float lastSample = 0.0f;
+    std::array<int, 4> periodHistory{};
+    int periodIndex = 0;
+    float period = 0.0f;
+    int sampleCount = 0;
+    float oscPhase = 0.0f;
+    float envelope = 0.0f;
+    float subGain = 0.0f;
+  };
+
+  static void registerPeriod(int period, ChannelState &s) {
+    if (period <= minPeriod || period >= maxPeriod)
+      return;
+
+    auto &history = s.periodHistory;
+    if (s.period > 0.0f && std::abs((float)period - s.period) >
+                               s.period * SubOctave::stabilityThreshold) {
+      history.fill(0);
+      s.periodIndex = 0;
+      s.period = 0.0f;
+      s.subGain = 0.0f;
+      s.oscPhase = 0.0f;
+    }
+
+    history[(size_t)s.periodIndex] = period;
+    s.periodIndex = (s.periodIndex + 1) % (int)history.size();
+
+    for (auto p : history)
+      if (p <= 0)
+        return;
+
+    auto average = 0.0f;
+    for (auto p : history)
+      average += (float)p;
+    average /= (float)history.size();
+
+    auto maxDeviation = 0.0f;
+    for (auto p : history)
+      maxDeviation = juce::jmax(maxDeviation, std::abs((float)p - average));
+
+    if (maxDeviation < average * SubOctave::stabilityThreshold)
+      s.period = average;
+  }
+
+  static void processChannel(float *data, int numSamples, float amount,
+                             ChannelState &s) {
+    constexpr auto twoPi = juce::MathConstants<float>::twoPi;
+
+    for (int i = 0; i < numSamples; ++i) {
+      const auto sample = data[i];
+      const auto lastSample = s.lastSample;
+      s.lastSample = sample;
+      ++s.sampleCount;
+
+      if (lastSample <= 0.0f && sample > 0.0f) {
+        registerPeriod(s.sampleCount, s);
+        s.sampleCount = 0;
+      }
+
+      s.envelope = s.envelope * SubOctave::envelopeRelease +
+                   std::abs(sample) * SubOctave::envelopeAttack;
+
+      if (s.period > 0.0f && s.envelope > 0.01f) {
+        s.oscPhase += twoPi / (s.period * 2.0f);
+        if (s.oscPhase >= twoPi)
+          s.oscPhase -= twoPi;
+        s.subGain = juce::jmin(1.0f, s.subGain + SubOctave::subGainAttack);
+      } else {
+        s.subGain = juce::jmax(0.0f, s.subGain - SubOctave::subGainRelease);
+      }
+
+      const auto subOctave = std::sin(s.oscPhase) * s.envelope * s.subGain;
+      data[i] = sample + subOctave * amount * SubOctave::mixScale;
+    }
+  }
+
+  std::array<ChannelState, 2> state;
+};
+
+// A two-partial note plus a little noise, with a new note every second
+void renderGuitar(juce::AudioBuffer<float> &dest, juce::Random &random,
+                  double &phase, double &frequency, int &samplesLeft) {
+  for (int i = 0; i < dest.getNumSamples(); ++i) {
+    if (--samplesLeft <= 0) {
+      frequency = 60.0 + 300.0 * random.nextDouble();
+      samplesLeft = (int)Benchmark::sampleRate;
+    }
+
+    phase += juce::MathConstants<double>::twoPi * frequency /
+             Benchmark::sampleRate;
+    const auto x = 0.5 * std::sin(phase) + 0.2 * std::sin(2.0 * phase) +
+                   0.01 * (2.0 * random.nextDouble() - 1.0);
+    for (int ch = 0; ch < dest.getNumChannels(); ++ch)
+      dest.setSample(ch, i, (float)x);
+  }
+}
+} // namespace
+
+void Benchmark::runSubOctaveBenchmarks() {
+  std::printf("Thicken: SubOctave against the reference port of "
+              "amp-processor.js\n");
+
+  // A few seconds of input, replayed block by block
+  constexpr int numBlocks = (int)(4.0 * sampleRate) / blockSize;
+  juce::AudioBuffer<float> input(2, numBlocks * blockSize);
+  {
+    juce::Random random(1);
+    double phase = 0.0, frequency = 0.0;
+    int samplesLeft = 0;
+    renderGuitar(input, random, phase, frequency, samplesLeft);
+  }
+
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  juce::dsp::AudioBlock<float> block(buffer);
+  constexpr float amount = 0.7f;
+
+  int next = 0;
+  auto processNext = [&](auto &processor) {
+    for (int ch = 0; ch < 2; ++ch)
+      buffer.copyFrom(ch, 0, input, ch, next * blockSize, blockSize);
+    next = (next + 1) % numBlocks;
+    if constexpr (std::is_same_v<std::decay_t<decltype(processor)>,
+                                 PitchTracker>)
+      processor.process(block);
+    else
+      processor.process(block, amount);
+  };
+
+  auto time = [&](auto &processor) {
+    next = 0;
+    return microsecondsPerCall([&] { processNext(processor); });
+  };
+
+  // The tracker spreads its analysis over several blocks, so the mean
+  // hides the blocks that carry an FFT. This is the slowest one.
+  auto worst = [&](auto &processor) {
+    return worstMicrosecondsPerCall(
+        [&] {
+          processor.reset();
+          next = 0;
+        },
+        [&] { processNext(processor); });
+  };
+
+  ReferenceSubOctave reference;
+  const auto referenceMicros = time(reference);
+  const auto referenceWorst = worst(reference);
+
+  SubOctave thicken;
+  thicken.prepare(sampleRate);
+  const auto thickenMicros = time(thicken);
+  const auto thickenWorst = worst(thicken);
+
+  // The YIN tracker that replaced the zero-crossing one, on its own, so
+  // the rest of SubOctave can be read off as the difference
+  PitchTracker tracker;
+  tracker.prepare(sampleRate);
+  const auto trackerMicros = time(tracker);
+  const auto trackerWorst = worst(tracker);
+
+  report("reference port", referenceMicros, referenceMicros);
+  report("SubOctave", thickenMicros, referenceMicros);
+  report("  of which PitchTracker", trackerMicros, referenceMicros);
+  report("reference port, slowest block", referenceWorst, referenceWorst);
+  report("SubOctave, slowest block", thickenWorst, referenceWorst);
+  report("  of which PitchTracker", trackerWorst, referenceWorst);
+  std::printf("\n");
+}
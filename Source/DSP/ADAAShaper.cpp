@@ -0,0 +1,241 @@
+#include "ADAAShaper.h"
+
+using namespace StrangerCurve;
+
+namespace {
+using StereoVec = ADAAShaper::StereoVec;
+
+// Builds the table on first use; later instances share the cached copy
+const chowdsp::LookupTableTransform<double> &
+getTable(chowdsp::LookupTableCache &cache, const std::string &id,
+         double (*function)(double), double range, size_t size) {
+  static juce::CriticalSection lock;
+  const juce::ScopedLock sl(lock);
+
+  auto &table = cache.addLookupTable<double>(id);
+  if (table.initialiseIfNotAlreadyInitialised())
+    table.initialise(function, 0.0, range, size);
+
+  return table;
+}
+
+// One channel per lane of SampleType
+template <typename SampleType> struct Lanes {
+  explicit Lanes(float *const *channels) noexcept {
+    std::copy(channels, channels + size, data.begin());
+  }
+
+  SampleType read(int i) const noexcept {
+    if constexpr (size == 1)
+      return (double)data[0][i];
+    else
+      return SampleType((double)data[0][i], (double)data[1][i]);
+  }
+
+  void write(int i, SampleType y) const noexcept {
+    if constexpr (size == 1) {
+      data[0][i] = (float)y;
+    } else {
+      data[0][i] = (float)y.get(0);
+      data[1][i] = (float)y.get(1);
+    }
+  }
+
+  static constexpr size_t size = std::is_same_v<SampleType, double> ? 1 : 2;
+  std::array<float *, size> data;
+};
+
+// fallback() in the lanes where condition holds, regular() elsewhere.
+// fallback() only runs when some lane needs it, and a scalar only
+// evaluates the side it takes.
+template <typename SampleType, typename Condition, typename Fallback,
+          typename Regular>
+SampleType selectLanes(const Condition &condition, Fallback &&fallback,
+                       Regular &&regular) noexcept {
+  if constexpr (std::is_same_v<SampleType, double>)
+    return condition ? fallback() : regular();
+  else
+    return xsimd::any(condition)
+               ? xsimd::select(condition, fallback(), regular())
+               : regular();
+}
+} // namespace
+
+ADAAShaper::ADAAShaper()
+    : ad1Table(getTable(*tableCache, "stranger_curve_ad1", shapeAD1<double>,
+                        tableRange, tableSize)) {}
+
+void ADAAShaper::reset() {
+  for (auto &s : state)
+    s = {};
+}
+
+void ADAAShaper::setDrive(float newDrive) {
+  if (juce::exactlyEqual(newDrive, drive))
+    return;
+
+  const auto newInScale = inputScale(newDrive);
+
+  // The history is stored pre-scaled; bring it to the new drive so the
+  // divided differences stay continuous across the change
+  const auto ratio = inScale > 0.0 ? newInScale / inScale : 0.0;
+  for (auto &s : state) {
+    s.x1 *= ratio;
+    s.x2 *= ratio;
+    s.ad1_x1 = ad1(s.x1);
+    s.ad2_x1 = shapeAD2(s.x1);
+    s.d2 = dividedDifferenceAD2(s.x1, s.x2, s.ad2_x1, shapeAD2(s.x2));
+  }
+
+  drive = newDrive;
+  inScale = newInScale;
+  outScale = outputScale(newDrive);
+}
+
+StereoVec ADAAShaper::ad1(StereoVec v) const noexcept {
+  return StereoVec(ad1(v.get(0)), ad1(v.get(1)));
+}
+
+template <typename SampleType>
+ADAAShaper::History<SampleType>
+ADAAShaper::loadHistory(int firstChannel) const noexcept {
+  if constexpr (std::is_same_v<SampleType, double>) {
+    return state[(size_t)firstChannel];
+  } else {
+    const auto &l = state[(size_t)firstChannel];
+    const auto &r = state[(size_t)firstChannel + 1];
+    return {SampleType(l.x1, r.x1), SampleType(l.x2, r.x2),
+            SampleType(l.ad1_x1, r.ad1_x1), SampleType(l.ad2_x1, r.ad2_x1),
+            SampleType(l.d2, r.d2)};
+  }
+}
+
+template <typename SampleType>
+void ADAAShaper::storeHistory(const History<SampleType> &h,
+                              int firstChannel) noexcept {
+  if constexpr (std::is_same_v<SampleType, double>) {
+    state[(size_t)firstChannel] = h;
+  } else {
+    for (size_t lane = 0; lane < 2; ++lane)
+      state[(size_t)firstChannel + lane] = {h.x1.get(lane), h.x2.get(lane),
+                                            h.ad1_x1.get(lane),
+                                            h.ad2_x1.get(lane), h.d2.get(lane)};
+  }
+}
+
+template <typename SampleType>
+SampleType ADAAShaper::dividedDifferenceAD2(SampleType x0, SampleType x1,
+                                            SampleType ad2_x0,
+                                            SampleType ad2_x1) noexcept {
+  const auto dx = x0 - x1;
+  return selectLanes<SampleType>(
+      xsimd::abs(dx) < SampleType(secondOrderTolerance),
+      [&] { return shapeAD1(SampleType(0.5) * (x0 + x1)); },
+      [&] { return (ad2_x0 - ad2_x1) / dx; });
+}
+
+template <typename SampleType>
+void ADAAShaper::firstOrder(float *const *channels, int firstChannel,
+                            int numSamples) noexcept {
+  const Lanes<SampleType> lanes(channels);
+  auto h = loadHistory<SampleType>(firstChannel);
+  auto x1 = h.x1, x2 = h.x2;
+  auto ad1_x1 = h.ad1_x1;
+
+  const SampleType in(inScale), out(outScale), half(0.5);
+  const SampleType tolerance(firstOrderTolerance);
+
+  for (int i = 0; i < numSamples; ++i) {
+    const auto x = in * lanes.read(i);
+    const auto ad1_x0 = ad1(x);
+    const auto dx = x - x1;
+
+    const auto y = selectLanes<SampleType>(
+        xsimd::abs(dx) < tolerance, [&] { return shape(half * (x + x1)); },
+        [&] { return (ad1_x0 - ad1_x1) / dx; });
+
+    lanes.write(i, out * y);
+    x2 = x1;
+    x1 = x;
+    ad1_x1 = ad1_x0;
+  }
+
+  // Keep the second-order history valid in case the mode changes
+  h.x1 = x1;
+  h.x2 = x2;
+  h.ad1_x1 = ad1_x1;
+  h.ad2_x1 = shapeAD2(x1);
+  h.d2 = dividedDifferenceAD2(x1, x2, h.ad2_x1, shapeAD2(x2));
+  storeHistory(h, firstChannel);
+}
+
+template <typename SampleType>
+void ADAAShaper::secondOrder(float *const *channels, int firstChannel,
+                             int numSamples) noexcept {
+  const Lanes<SampleType> lanes(channels);
+  auto h = loadHistory<SampleType>(firstChannel);
+  auto x1 = h.x1, x2 = h.x2;
+  auto ad2_x1 = h.ad2_x1;
+  auto d2 = h.d2;
+
+  const SampleType in(inScale), out(outScale), half(0.5), two(2.0);
+  const SampleType tolerance(secondOrderTolerance);
+
+  for (int i = 0; i < numSamples; ++i) {
+    const auto x = in * lanes.read(i);
+    const auto ad2_x0 = shapeAD2(x);
+    const auto d1 = dividedDifferenceAD2(x, x1, ad2_x0, ad2_x1);
+
+    // Ill-conditioned: fall back to the first-order estimate about x1
+    const auto firstOrderEstimate = [&] {
+      const auto xBar = half * (x + x2);
+      const auto delta = xBar - x1;
+      return selectLanes<SampleType>(
+          xsimd::abs(delta) < tolerance,
+          [&] { return shape(half * (xBar + x1)); },
+          [&] {
+            return (two / delta) *
+                   (shapeAD1(xBar) + (ad2_x1 - shapeAD2(xBar)) / delta);
+          });
+    };
+
+    const auto y = selectLanes<SampleType>(
+        xsimd::abs(x - x2) < tolerance, firstOrderEstimate,
+        [&] { return (two / (x - x2)) * (d1 - d2); });
+
+    lanes.write(i, out * y);
+    d2 = d1;
+    x2 = x1;
+    x1 = x;
+    ad2_x1 = ad2_x0;
+  }
+
+  h.x1 = x1;
+  h.x2 = x2;
+  h.ad1_x1 = ad1(x1);
+  h.ad2_x1 = ad2_x1;
+  h.d2 = d2;
+  storeHistory(h, firstChannel);
+}
+
+void ADAAShaper::processFirstOrder(float *const *channels, int numChannels,
+                                   int numSamples) noexcept {
+  if (numChannels == 2) {
+    firstOrder<StereoVec>(channels, 0, numSamples);
+    return;
+  }
+
+  for (int ch = 0; ch < numChannels; ++ch)
+    firstOrder<double>(channels + ch, ch, numSamples);
+}
+
+void ADAAShaper::processSecondOrder(float *const *channels, int numChannels,
+                                    int numSamples) noexcept {
+  if (numChannels == 2) {
+    secondOrder<StereoVec>(channels, 0, numSamples);
+    return;
+  }
+
+  for (int ch = 0; ch < numChannels; ++ch)
+    secondOrder<double>(channels + ch, ch, numSamples);
+}
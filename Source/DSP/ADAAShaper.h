@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <chowdsp_dsp_data_structures/chowdsp_dsp_data_structures.h>
+#include <chowdsp_simd/chowdsp_simd.h>
+#include <cmath>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+ * The Stranger drive curve factored into a drive-independent shape:
+ *
+ *   applyDistortion(x, k) == outputScale(k) * shape(inputScale(k) * x)
+ *
+ * with shape(v) = v / (1 + |v|). The antiderivatives of shape() have closed
+ * forms, so a single set of functions serves every drive setting.
+ *
+ * The shape functions take any SampleType: float, double or an xsimd batch
+ * of either, so one implementation serves scalar and multi-lane code.
+ */
+namespace StrangerCurve {
+template <typename SampleType>
+inline SampleType shape(SampleType v) noexcept {
+  return v / (SampleType(1) + xsimd::abs(v));
+}
+
+// First antiderivative (even)
+template <typename SampleType>
+inline SampleType shapeAD1(SampleType v) noexcept {
+  const auto u = xsimd::abs(v);
+  return u - xsimd::log1p(u);
+}
+
+// Second antiderivative (odd)
+template <typename SampleType>
+inline SampleType shapeAD2(SampleType v) noexcept {
+  const auto u = xsimd::abs(v);
+  const SampleType half(0.5), one(1);
+  return xsimd::copysign(half * u * u - ((one + u) * xsimd::log1p(u) - u), v);
+}
+
+inline double inputScale(float drive) noexcept {
+  return (double)drive / juce::MathConstants<double>::pi;
+}
+
+inline double outputScale(float drive) noexcept {
+  return (3.0 + (double)drive) * juce::MathConstants<double>::pi /
+         (9.0 * (double)drive);
+}
+} // namespace StrangerCurve
+
+//==============================================================================
+/**
+ * Antiderivative anti-aliased (ADAA) version of the Stranger drive curve.
+ *
+ * First order adds half a sample of delay, second order a full sample. The
+ * recursion follows chowdsp::ADAAWaveshaper.
+ *
+ * The antiderivatives do not depend on the drive, so the first-order path
+ * reads a single lookup table. That table serves every drive setting and
+ * every plugin instance: it is built once and shared through a
+ * chowdsp::SharedLookupTableCache. Second order keeps the closed forms,
+ * because its second divided difference amplifies table interpolation
+ * error too much.
+ *
+ * The recursions are written once for any SampleType. A stereo block runs
+ * both channels in the lanes of one two-lane double batch, a mono block
+ * in scalar doubles. The ill-conditioned fallbacks only run when a lane
+ * needs them.
+ */
+class ADAAShaper {
+public:
+  using StereoVec = xsimd::make_sized_batch_t<double, 2>;
+  static_assert(!std::is_void_v<StereoVec>,
+                "Target has no two-lane double SIMD type");
+
+  static constexpr int maxChannels = 2;
+
+  ADAAShaper();
+
+  void reset();
+
+  // Call before processing a block; rescales the history on drive changes
+  void setDrive(float newDrive);
+
+  void processFirstOrder(float *const *channels, int numChannels,
+                         int numSamples) noexcept;
+  void processSecondOrder(float *const *channels, int numChannels,
+                          int numSamples) noexcept;
+
+private:
+  // Smallest input step (in shape() units) before the midpoint fallback
+  static constexpr double firstOrderTolerance = 1.0e-5;
+  static constexpr double secondOrderTolerance = 1.0e-3;
+
+  // The first antiderivative table covers |v| in [0, tableRange]
+  static constexpr double tableRange = 128.0;
+  static constexpr size_t tableSize = 1 << 18;
+
+  double ad1(double v) const noexcept {
+    const auto u = std::abs(v);
+    return u < tableRange ? ad1Table.processSampleUnchecked(u)
+                          : StrangerCurve::shapeAD1(v);
+  }
+
+  // The table has no SIMD lookup, so each lane reads it in turn
+  StereoVec ad1(StereoVec v) const noexcept;
+
+  // Inputs scaled by inputScale(), and what the recursions derived from
+  // them; one channel per lane
+  template <typename SampleType> struct History {
+    SampleType x1 = SampleType(0.0), x2 = SampleType(0.0); // Previous inputs
+    SampleType ad1_x1 = SampleType(0.0); // shapeAD1(x1)
+    SampleType ad2_x1 = SampleType(0.0); // shapeAD2(x1)
+    SampleType d2 = SampleType(0.0);     // Previous first divided difference
+  };
+
+  // The history of the channels from firstChannel, one per lane
+  template <typename SampleType>
+  History<SampleType> loadHistory(int firstChannel) const noexcept;
+  template <typename SampleType>
+  void storeHistory(const History<SampleType> &h, int firstChannel) noexcept;
+
+  template <typename SampleType>
+  void firstOrder(float *const *channels, int firstChannel,
+                  int numSamples) noexcept;
+  template <typename SampleType>
+  void secondOrder(float *const *channels, int firstChannel,
+                   int numSamples) noexcept;
+
+  template <typename SampleType>
+  static SampleType dividedDifferenceAD2(SampleType x0, SampleType x1,
+                                         SampleType ad2_x0,
+                                         SampleType ad2_x1) noexcept;
+
+  chowdsp::SharedLookupTableCache tableCache;
+  const chowdsp::LookupTableTransform<double> &ad1Table;
+
+  float drive = 0.0f;
+  double inScale = 0.0, outScale = 0.0;
+  std::array<History<double>, maxChannels> state{};
+};
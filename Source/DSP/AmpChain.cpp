@@ -0,0 +1,399 @@
+#include "AmpChain.h"
+
+namespace {
+constexpr double gainRampSeconds = 0.02;
+constexpr float lofiAttenuation = 0.8f;
+
+// Tone settings must hold this long before they are baked into the IR
+constexpr double toneFoldHoldSeconds = 0.25;
+
+// Identical input needed beyond the cabinet's memory before running
+// dual-mono; covers the oversampling filters and the ADAA history
+constexpr double dualMonoMarginSeconds = 0.05;
+
+// Fade from the left drive output to the right once dual-mono ends
+constexpr double driveResyncSeconds = 0.02;
+
+// Silence needed beyond the cabinet's memory before sleeping; covers the
+// oversampling filters and the tone filters ringing out
+constexpr double sleepMarginSeconds = 0.05;
+
+float getPeak(const juce::dsp::AudioBlock<float> &block) {
+  const auto range = block.findMinAndMax();
+  return juce::jmax(-range.getStart(), range.getEnd());
+}
+} // namespace
+
+//==============================================================================
+AmpChain::AmpChain(const juce::AudioProcessorValueTreeState &vts)
+    : drive(vts), toneFoldParam(vts.getRawParameterValue("cabToneFold")),
+      chugSplitParam(vts.getRawParameterValue("chugSplit")) {
+  // addParameters() was not called
+  jassert(toneFoldParam != nullptr && chugSplitParam != nullptr);
+
+  // Fixed voicings
+  toneStack.setDesign(BiquadCascade::LowBoost,
+                      {BiquadType::LowShelf, 80.0f, 1.0f, 8.0f});
+  toneStack.setDesign(BiquadCascade::LofiLowPass,
+                      {BiquadType::LowPass, 2000.0f, 0.7f, 0.0f});
+  toneStack.setDesign(BiquadCascade::LofiHighPass,
+                      {BiquadType::HighPass, 300.0f, 0.7f, 0.0f});
+
+  // The tone controls are always in circuit
+  for (auto section : {BiquadCascade::Bass, BiquadCascade::Mid,
+                       BiquadCascade::Treble, BiquadCascade::Presence})
+    toneStack.setEnabled(section, true);
+}
+
+void AmpChain::addParameters(
+    juce::AudioProcessorValueTreeState::ParameterLayout &layout) {
+  DriveStage::addParameters(layout);
+
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+      "cabToneFold", "Fold Tone Into Cabinet", false));
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+      "chugSplit", "Chug Band Split", false));
+}
+
+void AmpChain::prepare(double sampleRate, int maxBlockSize, int numChannels) {
+  fs = sampleRate;
+  maxBlock = maxBlockSize;
+  numChannels = juce::jmin(numChannels, maxChannels);
+
+  inputGain.reset(sampleRate, gainRampSeconds);
+  outputGain.reset(sampleRate, gainRampSeconds);
+  gainRamp.assign((size_t)maxBlockSize, 0.0f);
+  meters.prepare(sampleRate, maxBlockSize);
+  driveFadeLength = juce::roundToInt(driveResyncSeconds * sampleRate);
+
+  thicken.prepare(sampleRate);
+  chug.prepare(sampleRate, maxBlockSize, numChannels);
+  drive.prepare(sampleRate, maxBlockSize, numChannels);
+  toneStack.prepare(sampleRate, maxBlockSize);
+  delay.prepare(sampleRate, numChannels);
+  cabinet.prepare(sampleRate, maxBlockSize, numChannels);
+  reverb.prepare(sampleRate, maxBlockSize, numChannels);
+
+  reset();
+}
+
+void AmpChain::reset() {
+  thicken.reset();
+  chug.reset();
+  drive.reset();
+
+  toneStack.reset();
+
+  delay.reset();
+  cabinet.reset();
+  reverb.reset();
+  meters.reset();
+
+  toneSettledSamples = 0;
+  wasReverbActive = false;
+
+  dualMono = false;
+  identicalSamples = 0;
+  driveFadeRemaining = 0;
+
+  sleeping = false;
+  quietSamples = 0;
+  cabinetMemory.store(cabinet.getMemoryLength(), std::memory_order_relaxed);
+}
+
+double AmpChain::getTailSeconds(const AmpParameters &p) const {
+  // The stages run in series, so their tails add up
+  double seconds = 0.0;
+
+  if (p.delayEnabled && p.delayMix > 0.0f)
+    seconds += FeedbackDelay::getTailSeconds(p.delayTimeSeconds,
+                                             p.delayFeedback);
+
+  if (!p.irBypass)
+    seconds += cabinetMemory.load(std::memory_order_relaxed) / fs;
+
+  if (p.reverbEnabled && p.reverbMix > 0.0f)
+    seconds += ReverbStage::getTailSeconds(p.reverbType, p.reverbDecay);
+
+  return seconds;
+}
+
+//==============================================================================
+void AmpChain::updateFilters(const AmpParameters &params) {
+  // Only sections whose settings changed are recomputed
+  toneStack.setDesign(BiquadCascade::Bass,
+                      {BiquadType::LowShelf, 200.0f, 1.0f, params.bassDB});
+  toneStack.setDesign(BiquadCascade::Mid,
+                      {BiquadType::Peaking, 1000.0f, 1.0f, params.midDB});
+  toneStack.setDesign(BiquadCascade::Treble,
+                      {BiquadType::HighShelf, 4000.0f, 1.0f, params.trebleDB});
+  toneStack.setDesign(
+      BiquadCascade::Presence,
+      {BiquadType::HighShelf, 6000.0f, 1.0f, params.presenceDB});
+
+  for (size_t i = 0; i < params.peqBands.size(); ++i) {
+    const auto &band = params.peqBands[i];
+    toneStack.setDesign(
+        (BiquadCascade::Section)(BiquadCascade::Peq1 + (int)i),
+        {BiquadType::Peaking, band.freq, band.q, band.gainDB});
+  }
+}
+
+void AmpChain::process(juce::AudioBuffer<float> &buffer,
+                       const AmpParameters &params) {
+  const auto numChannels = juce::jmin(buffer.getNumChannels(), maxChannels);
+  juce::dsp::AudioBlock<float> fullBlock(buffer.getArrayOfWritePointers(),
+                                         (size_t)numChannels,
+                                         (size_t)buffer.getNumSamples());
+
+  // Nothing left ringing and nothing coming in: skip the whole chain
+  const bool inputSilent = getPeak(fullBlock) < silenceThreshold;
+  if (sleeping && inputSilent) {
+    fullBlock.clear();
+
+    // Let the meters fall to silence
+    if (meters.isEnabled()) {
+      for (int tap = 0; tap < MeterFeed::numTaps; ++tap)
+        meters.measure((MeterFeed::Tap)tap, fullBlock);
+      meters.publish(fullBlock, inputGain.getCurrentValue() *
+                                    outputGain.getCurrentValue());
+    }
+    return;
+  }
+  sleeping = false;
+
+  updateFilters(params);
+  drive.updateOversampling();
+
+  inputGain.setTargetValue(params.inputGain);
+  outputGain.setTargetValue(params.outputGain);
+
+  // Hosts may exceed the prepared block size; never process more than that
+  for (size_t start = 0; start < fullBlock.getNumSamples();
+       start += (size_t)maxBlock) {
+    auto block = fullBlock.getSubBlock(
+        start, juce::jmin((size_t)maxBlock, fullBlock.getNumSamples() - start));
+    processBlock(block, params);
+  }
+
+  updateSleep(inputSilent, getPeak(fullBlock) < silenceThreshold,
+              buffer.getNumSamples());
+}
+
+void AmpChain::updateSleep(bool inputSilent, bool outputSilent,
+                           int numSamples) {
+  const auto memory = cabinet.getMemoryLength();
+  cabinetMemory.store(memory, std::memory_order_relaxed);
+
+  if (!inputSilent || !outputSilent) {
+    quietSamples = 0;
+    return;
+  }
+
+  // The delay and reverb know when their tails have died away; everything
+  // else forgets its input within the cabinet's memory and the margin
+  quietSamples += numSamples;
+  const auto hold = memory + juce::roundToInt(sleepMarginSeconds * fs);
+  sleeping = quietSamples >= hold && delay.isSilent() &&
+             (!wasReverbActive || !reverb.isActive());
+}
+
+void AmpChain::processTone(juce::dsp::AudioBlock<float> &block, bool lofi) {
+  toneStack.process(block);
+
+  if (lofi)
+    block.multiplyBy(lofiAttenuation);
+}
+
+void AmpChain::updateToneFold(bool foldEnabled, bool cabinetBypassed,
+                              bool lofi, int numSamples) {
+  const bool wasToneLive = cabinet.isToneLive();
+
+  auto update = [&] {
+    // Nothing to fold into, and nothing audible to fade
+    if (cabinetBypassed) {
+      cabinet.dropToneFold();
+      toneSettledSamples = 0;
+      return;
+    }
+
+    // Custom IRs play with the live filters
+    if (!foldEnabled || cabinet.isCustomIRActive()) {
+      cabinet.setUseToneFold(false);
+      toneSettledSamples = 0;
+      return;
+    }
+
+    const CabinetSim::ToneFold tone{toneStack.getSnapshot(),
+                                    lofi ? lofiAttenuation : 1.0f};
+
+    // Back to the live filters as soon as a control moves
+    const bool moving = toneStack.isGliding() || tone != settlingTone;
+    if (moving || !cabinet.hasToneFold(tone))
+      cabinet.setUseToneFold(false);
+
+    if (moving) {
+      settlingTone = tone;
+      toneSettledSamples = 0;
+      return;
+    }
+
+    if (toneSettledSamples < juce::roundToInt(toneFoldHoldSeconds * fs)) {
+      toneSettledSamples += numSamples;
+      return;
+    }
+
+    cabinet.requestToneFold(tone);
+    if (cabinet.hasToneFold(tone))
+      cabinet.setUseToneFold(true);
+  };
+  update();
+
+  // The filters sat idle while folded, so their state is stale. Changed
+  // sections jump to their new design.
+  if (!wasToneLive && cabinet.isToneLive())
+    toneStack.reset();
+}
+
+void AmpChain::updateDualMono(const juce::dsp::AudioBlock<float> &block) {
+  const auto numSamples = (int)block.getNumSamples();
+  const bool identical =
+      block.getNumChannels() == 2 &&
+      std::memcmp(block.getChannelPointer(0), block.getChannelPointer(1),
+                  (size_t)numSamples * sizeof(float)) == 0;
+
+  if (!identical) {
+    if (dualMono)
+      driveFadeRemaining = driveFadeLength;
+    dualMono = false;
+    identicalSamples = 0;
+    return;
+  }
+
+  if (dualMono)
+    return;
+
+  identicalSamples += numSamples;
+  dualMono = identicalSamples >=
+             cabinet.getMemoryLength() +
+                 juce::roundToInt(dualMonoMarginSeconds * fs);
+  if (dualMono)
+    driveFadeRemaining = 0;
+}
+
+void AmpChain::processDrive(juce::dsp::AudioBlock<float> &block,
+                            const AmpParameters &p) {
+  if (dualMono) {
+    auto left = block.getSingleChannelBlock(0);
+    drive.process(left, p.driveAmount, p.cleanse);
+    block.getSingleChannelBlock(1).copyFrom(left);
+    return;
+  }
+
+  drive.process(block, p.driveAmount, p.cleanse);
+  if (driveFadeRemaining <= 0)
+    return;
+
+  // The right oversampler and shaper history is stale; the left output is
+  // what the right would have been a moment ago
+  const auto numSamples = (int)block.getNumSamples();
+  const auto *left = block.getChannelPointer(0);
+  auto *right = block.getChannelPointer(1);
+
+  for (int i = 0; i < numSamples; ++i) {
+    const auto t = juce::jmin(
+        1.0f, (float)(driveFadeLength - driveFadeRemaining + i + 1) /
+                  (float)driveFadeLength);
+    right[i] = left[i] + t * (right[i] - left[i]);
+  }
+
+  driveFadeRemaining -= numSamples;
+}
+
+void AmpChain::processBlock(juce::dsp::AudioBlock<float> &block,
+                            const AmpParameters &p) {
+  const auto numSamples = (int)block.getNumSamples();
+  const auto numChannels = (int)block.getNumChannels();
+
+  // Settled gains are one vector multiply per channel. A moving gain is
+  // rendered once into gainRamp and applied to each channel as a vector.
+  auto applyGain = [&](juce::SmoothedValue<float> &gain) {
+    if (!gain.isSmoothing()) {
+      block.multiplyBy(gain.getTargetValue());
+      return;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+      gainRamp[(size_t)i] = gain.getNextValue();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+      juce::FloatVectorOperations::multiply(block.getChannelPointer((size_t)ch),
+                                            gainRamp.data(), numSamples);
+  };
+
+  const bool metering = meters.isEnabled();
+  if (metering)
+    meters.measure(MeterFeed::Input, block);
+
+  updateDualMono(block);
+  applyGain(inputGain);
+
+  if (p.thickenEnabled && p.thickenAmount > 0.0f)
+    thicken.process(block, p.thickenAmount);
+
+  if (p.chugEnabled && p.chugAmount > 0.0f)
+    chug.process(block, p.chugAmount, chugSplitParam->load() >= 0.5f);
+
+  processDrive(block, p);
+  if (metering)
+    meters.measure(MeterFeed::PostDrive, block);
+
+  toneStack.setEnabled(BiquadCascade::LowBoost, p.lowBoost);
+  for (int i = 0; i < 4; ++i)
+    toneStack.setEnabled((BiquadCascade::Section)(BiquadCascade::Peq1 + i),
+                         p.peqEnabled);
+  toneStack.setEnabled(BiquadCascade::LofiLowPass, p.lofi);
+  toneStack.setEnabled(BiquadCascade::LofiHighPass, p.lofi);
+
+  cabinet.setIRIndex(p.irIndex);
+  cabinet.setUseCustomIR(p.customIR);
+
+  // Folding needs the cabinet. While folding is on, the live filters run
+  // after the cabinet so switching IRs doesn't disturb the delay.
+  const bool foldEnabled = toneFoldParam->load() >= 0.5f;
+  updateToneFold(foldEnabled, p.irBypass, p.lofi, numSamples);
+
+  const bool tonePostCab =
+      !p.irBypass && (foldEnabled || cabinet.isToneFoldActive());
+  if (!tonePostCab)
+    processTone(block, p.lofi);
+
+  // Sleeps by itself once its tail has died away
+  delay.process(block, p.delayEnabled, p.delayTimeSeconds, p.delayFeedback,
+                p.delayMix);
+
+  applyGain(outputGain);
+
+  if (!p.irBypass)
+    cabinet.process(
+        block,
+        [&](juce::dsp::AudioBlock<float> &cabOut) {
+          if (tonePostCab)
+            processTone(cabOut, p.lofi);
+        },
+        dualMono);
+
+  const bool reverbActive = p.reverbEnabled && p.reverbMix > 0.0f;
+  if (reverbActive) {
+    if (!wasReverbActive)
+      reverb.reset();
+    reverb.setType(p.reverbType, p.reverbDecay);
+    reverb.process(block, p.reverbMix);
+  }
+  wasReverbActive = reverbActive;
+  if (metering) {
+    meters.measure(MeterFeed::Output, block);
+    meters.publish(block,
+                   inputGain.getCurrentValue() * outputGain.getCurrentValue());
+  }
+}
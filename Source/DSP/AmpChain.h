@@ -0,0 +1,147 @@
+#pragma once
+
+#include "AmpParameters.h"
+#include "BiquadCascade.h"
+#include "CabinetSim.h"
+#include "DriveStage.h"
+#include "FeedbackDelay.h"
+#include "MeterFeed.h"
+#include "ReverbStage.h"
+#include "SubOctave.h"
+#include "TransientShaper.h"
+
+//==============================================================================
+/**
+ * The complete Stranger Amps signal chain (see JUCE_PORTING_GUIDE.md):
+ *
+ *   Input gain -> [Thicken] -> [Chug] -> Drive -> [Low Boost] -> Bass ->
+ *   Mid -> Treble -> Presence -> [PEQ] -> [Lo-Fi] -> [Delay] ->
+ *   Output gain -> [Cabinet IR] -> [Reverb]
+ *
+ * With tone folding on, the filters from Low Boost to Lo-Fi are baked into the
+ * cabinet IR once the controls settle. They are linear and time-invariant,
+ * as are the delay and output gain, so moving them past those stages does
+ * not change the result. Delay and reverb stay outside the fold. While a
+ * tone control moves, the filters run live after the cabinet instead.
+ *
+ * Every buffer is allocated in prepare(). process() does no allocation,
+ * locking or string work, and bypassed stages are skipped entirely.
+ *
+ * The chain runs in float. The drive curve and ADAA kernels are written for
+ * any sample type, and the filters compute in double lanes. The oversampler,
+ * delay line and reverb are chowdsp templates that could be instantiated
+ * with double; only the cabinet can't, because its convolution needs
+ * juce::dsp::FFT, which transforms floats alone. The in-house stages
+ * (BiquadCascade, SubOctave, TransientShaper, the gains) are float because
+ * the cabinet would convert a double signal anyway, not because anything
+ * else blocks them.
+ *
+ * Everything before the reverb treats both channels alike. When the two
+ * input channels are bit-identical (a mono DI on a stereo track), the drive
+ * and cabinet run once and copy left to right; the cheaper stages already
+ * process both channels in one SIMD register.
+ *
+ * Once the input has been silent for longer than anything in the chain
+ * rings, the chain sleeps: process() clears the buffer and returns until
+ * the input comes back.
+ *
+ * While the UI reads the meter feed, every block's input, post-drive and
+ * output levels are published to it.
+ */
+class AmpChain {
+public:
+  static constexpr int maxChannels = 2;
+
+  explicit AmpChain(const juce::AudioProcessorValueTreeState &vts);
+
+  // Adds parameters owned by the chain itself (oversampling, tone folding,
+  // chug band split)
+  static void addParameters(
+      juce::AudioProcessorValueTreeState::ParameterLayout &layout);
+
+  void prepare(double sampleRate, int maxBlockSize, int numChannels);
+  void reset();
+
+  // Audio thread
+  void process(juce::AudioBuffer<float> &buffer, const AmpParameters &params);
+
+  // Message thread: imports a custom cabinet IR in the background
+  void loadCustomIR(const juce::File &file,
+                    const CustomIRLoader::Options &options = {}) {
+    cabinet.loadCustomIR(file, options);
+  }
+  const CustomIRLoader &getCustomIRLoader() const {
+    return cabinet.getCustomIRLoader();
+  }
+
+  // Levels and scope for the UI; the editor enables and drains it
+  MeterFeed &getMeterFeed() { return meters; }
+
+  // Latency of the active oversampling mode; may change between blocks
+  int getLatencySamples() const { return drive.getLatencySamples(); }
+
+  // Any thread: how long the chain keeps sounding after the input stops
+  double getTailSeconds(const AmpParameters &params) const;
+
+  // Peak level below which the input and output count as silent (-100 dB)
+  static constexpr float silenceThreshold = 1.0e-5f;
+
+private:
+  void processBlock(juce::dsp::AudioBlock<float> &block,
+                    const AmpParameters &params);
+  void updateFilters(const AmpParameters &params);
+  void processTone(juce::dsp::AudioBlock<float> &block, bool lofi);
+
+  // Picks baked or live tone filters for the next block
+  void updateToneFold(bool foldEnabled, bool cabinetBypassed, bool lofi,
+                      int numSamples);
+
+  // Decides from the input whether this block can run dual-mono
+  void updateDualMono(const juce::dsp::AudioBlock<float> &block);
+
+  // Decides after a block whether the chain can sleep
+  void updateSleep(bool inputSilent, bool outputSilent, int numSamples);
+  void processDrive(juce::dsp::AudioBlock<float> &block,
+                    const AmpParameters &params);
+
+  double fs = 48000.0;
+  int maxBlock = 0;
+
+  // Combined input (level * gain) and output (master * level) gains
+  juce::SmoothedValue<float> inputGain, outputGain;
+  std::vector<float> gainRamp; // Audio thread: a moving gain, per sample
+
+  SubOctave thicken;
+  TransientShaper chug;
+  DriveStage drive;
+
+  // Low boost, tone controls, PEQ and lofi filters
+  BiquadCascade toneStack;
+
+  FeedbackDelay delay;
+  CabinetSim cabinet;
+  ReverbStage reverb;
+
+  MeterFeed meters;
+
+  std::atomic<float> *toneFoldParam = nullptr;
+  std::atomic<float> *chugSplitParam = nullptr;
+  CabinetSim::ToneFold settlingTone;
+  int toneSettledSamples = 0;
+
+  bool wasReverbActive = false;
+
+  // Asleep until the input is audible again
+  bool sleeping = false;
+  int quietSamples = 0; // Input and output both silent
+  std::atomic<int> cabinetMemory{0}; // For getTailSeconds()
+
+  // Dual-mono starts once the input has been identical for longer than the
+  // chain remembers. After it ends, the right drive output fades in while
+  // its skipped state settles.
+  bool dualMono = false;
+  int identicalSamples = 0;
+  int driveFadeLength = 0, driveFadeRemaining = 0;
+
+  JUCE_DECLARE_NON_COPYABLE(AmpChain)
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+
+//==============================================================================
+/**
+ * Plain per-block snapshot of every control the amp chain reads.
+ *
+ * Values are already converted to DSP units (linear gains, dB, Hz, seconds)
+ * using the formulas from JUCE_PORTING_GUIDE.md, so the audio thread never
+ * has to touch the parameter tree.
+ */
+struct AmpParameters {
+  struct PeqBand {
+    float freq = 1000.0f; // Hz
+    float gainDB = 0.0f;
+    float q = 1.0f;
+  };
+
+  // Input section: inputLevel (0 - 1.5) * inputGain (0 - 2.0)
+  float inputGain = 1.5f;
+
+  // Tone stack gains in dB
+  float bassDB = 0.0f;
+  float midDB = 0.0f;
+  float trebleDB = 0.0f;
+  float presenceDB = 0.0f;
+
+  // Overdrive
+  float driveAmount = 50.0f;
+  bool lowBoost = false;
+  bool cleanse = false;
+
+  // Thicken / Chug (0 - 1)
+  bool thickenEnabled = false;
+  float thickenAmount = 0.0f;
+  bool chugEnabled = false;
+  float chugAmount = 0.0f;
+
+  bool lofi = false;
+
+  // Parametric EQ
+  bool peqEnabled = false;
+  std::array<PeqBand, 4> peqBands{
+      {{100.0f, 0.0f, 1.0f},
+       {500.0f, 0.0f, 1.0f},
+       {2000.0f, 0.0f, 1.0f},
+       {8000.0f, 0.0f, 1.0f}}};
+
+  // Delay
+  bool delayEnabled = false;
+  float delayTimeSeconds = 0.4f;
+  float delayFeedback = 0.32f; // 0 - 0.8
+  float delayMix = 0.3f;       // 0 - 1
+
+  // Output section: masterVolume (0 - 1.0) * outputLevel (0 - 1.5)
+  float outputGain = 0.375f;
+
+  // Cabinet
+  int irIndex = 0;
+  bool irBypass = false;
+  bool customIR = false; // play the loaded custom IR instead of irIndex
+
+  // Reverb
+  bool reverbEnabled = false;
+  int reverbType = 1; // see ReverbStage::Type
+  float reverbMix = 0.2f;   // 0 - 1
+  float reverbDecay = 5.0f; // raw 0 - 10 knob value
+};
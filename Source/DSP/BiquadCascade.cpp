@@ -0,0 +1,351 @@
+#include "BiquadCascade.h"
+
+//==============================================================================
+void BiquadCascade::SVF::setCoefficients(const BiquadCoeffs &c) noexcept {
+  const double b0 = c.b0, b1 = c.b1, b2 = c.b2, a1 = c.a1, a2 = c.a2;
+
+  const auto tau = 1.0 - a1 + a2;
+  const auto fourGSqr = (4.0 / tau) * (1.0 + a1 + a2);
+
+  g2 = std::sqrt(fourGSqr);
+  R2 = 4.0 * (1.0 - a2) / (g2 * tau);
+  c0 = (b0 - b1 + b2) / tau;
+  c1 = 4.0 * (b0 - b2) / (g2 * tau);
+  c2 = 4.0 * (b0 + b1 + b2) / (fourGSqr * tau);
+
+  g = 0.5 * g2;
+  twoGSqr = 0.5 * fourGSqr;
+  h = 1.0 / (1.0 + R2 * g + 0.25 * fourGSqr);
+
+  c1 += c2 * g;
+  c0 += c1 * g;
+}
+
+BiquadCascade::StereoVec
+BiquadCascade::SVF::processSample(StereoVec x) noexcept {
+  const auto hp = (x - (g + R2) * m1 - m2) * h;
+  const auto y = c0 * hp + c1 * m1 + c2 * m2;
+
+  m2 = twoGSqr * hp + g2 * m1 + m2;
+  m1 = g2 * hp + m1;
+  return y;
+}
+
+// With no input, y[0] = C1 m1 + C2 m2 and y[1] = D1 m1 + D2 m2. Matching
+// those two outputs pins down the state of any second-order realisation.
+void BiquadCascade::SVF::setStateFrom(
+    const chowdsp::IIRFilter<2, StereoVec> &filter) noexcept {
+  const auto p1 = -(g + R2) * h, p2 = -h;
+  const auto C1 = c0 * p1 + c1, C2 = c0 * p2 + c2;
+  const auto D1 = C1 * (g2 * p1 + 1.0) + C2 * (twoGSqr * p1 + g2);
+  const auto D2 = C1 * g2 * p2 + C2 * (twoGSqr * p2 + 1.0);
+  const auto det = C1 * D2 - C2 * D1;
+
+  if (std::abs(det) < 1.0e-12) {
+    m1 = m2 = 0.0;
+    return;
+  }
+
+  // Direct Form II: y[0] = z1, y[1] = z2 - a1 z1
+  const auto &z = filter.z[0];
+  const auto y0 = z[1];
+  const auto y1 = z[2] - filter.a[1] * z[1];
+
+  m1 = (D2 * y0 - C2 * y1) / det;
+  m2 = (C1 * y1 - D1 * y0) / det;
+}
+
+void BiquadCascade::SVF::copyStateTo(chowdsp::IIRFilter<2, StereoVec> &filter,
+                                     const BiquadCoeffs &c) const noexcept {
+  const auto p1 = -(g + R2) * h, p2 = -h;
+  const auto C1 = c0 * p1 + c1, C2 = c0 * p2 + c2;
+  const auto D1 = C1 * (g2 * p1 + 1.0) + C2 * (twoGSqr * p1 + g2);
+  const auto D2 = C1 * g2 * p2 + C2 * (twoGSqr * p2 + 1.0);
+
+  const auto y0 = C1 * m1 + C2 * m2;
+  const auto y1 = D1 * m1 + D2 * m2;
+
+  auto &z = filter.z[0];
+  z[1] = y0;
+  z[2] = y1 + (double)c.a1 * y0;
+}
+
+//==============================================================================
+void BiquadCascade::prepare(double sampleRate, int maxBlockSize) {
+  fs = sampleRate;
+  glideTicks = juce::jmax(
+      1, juce::roundToInt(glideSeconds * sampleRate / controlInterval));
+  interleaved.resize((size_t)maxBlockSize);
+
+  for (auto &s : sections) {
+    s.current = s.target;
+    s.glideSteps = 0;
+    s.useSVF = false;
+    setCoefficients(s, s.current);
+  }
+
+  reset();
+}
+
+void BiquadCascade::reset() {
+  for (auto &s : sections) {
+    if (s.glideSteps > 0 && fs > 0.0) {
+      s.current = s.target;
+      s.glideSteps = 0;
+      setCoefficients(s, s.current);
+    }
+
+    s.useSVF = false;
+    s.direct.reset();
+    s.svf.m1 = s.svf.m2 = 0.0;
+  }
+
+  activeListDirty = true;
+}
+
+void BiquadCascade::setCoefficients(SectionState &s, const Design &design) {
+  s.coeffs = calculateBiquadCoeffs(design.frequency, design.q, design.gainDB,
+                                   design.type, fs);
+
+  const double b[] = {s.coeffs.b0, s.coeffs.b1, s.coeffs.b2};
+  const double a[] = {1.0, s.coeffs.a1, s.coeffs.a2};
+  for (size_t i = 0; i < 3; ++i) {
+    s.direct.b[i] = StereoVec(b[i]);
+    s.direct.a[i] = StereoVec(a[i]);
+  }
+}
+
+void BiquadCascade::setDesign(Section section, const Design &design) {
+  auto &s = sections[(size_t)section];
+  if (design == s.target)
+    return;
+
+  const bool wasUnity = s.targetIsUnity;
+  s.targetIsUnity = isUnity(design);
+
+  if (fs > 0.0 && s.enabled) {
+    startGlide(s, design);
+  } else {
+    // Not audible: jump straight to the new design
+    s.current = s.target = design;
+    s.glideSteps = 0;
+    if (fs > 0.0)
+      setCoefficients(s, design);
+  }
+
+  if (wasUnity != s.targetIsUnity || s.useSVF)
+    activeListDirty = true;
+}
+
+void BiquadCascade::setEnabled(Section section, bool shouldBeEnabled) {
+  auto &s = sections[(size_t)section];
+  if (s.enabled == shouldBeEnabled)
+    return;
+
+  s.enabled = shouldBeEnabled;
+  activeListDirty = true;
+}
+
+void BiquadCascade::startGlide(SectionState &s, const Design &newTarget) {
+  s.glideStart = s.current;
+  s.target = newTarget;
+  s.glideStep = 0;
+  s.glideSteps = glideTicks;
+
+  if (!s.useSVF) {
+    s.svf.setCoefficients(s.coeffs);
+    s.svf.setStateFrom(s.direct);
+    s.useSVF = true;
+  }
+}
+
+void BiquadCascade::advanceGlide(SectionState &s) {
+  auto d = s.target;
+
+  if (++s.glideStep < s.glideSteps) {
+    const auto t = (float)s.glideStep / (float)s.glideSteps;
+    const auto &from = s.glideStart;
+    d.frequency = from.frequency + (d.frequency - from.frequency) * t;
+    d.q = from.q + (d.q - from.q) * t;
+    d.gainDB = from.gainDB + (d.gainDB - from.gainDB) * t;
+  } else {
+    s.glideSteps = 0;
+  }
+
+  s.current = d;
+  setCoefficients(s, d);
+  s.svf.setCoefficients(s.coeffs);
+}
+
+void BiquadCascade::finishGlide(SectionState &s) {
+  s.svf.copyStateTo(s.direct, s.coeffs);
+  s.useSVF = false;
+
+  if (s.targetIsUnity)
+    activeListDirty = true;
+}
+
+void BiquadCascade::updateActiveSections() {
+  numActive = 0;
+
+  for (int i = 0; i < numSections; ++i) {
+    auto &s = sections[(size_t)i];
+    const bool isNowActive = s.enabled && (!s.targetIsUnity || s.useSVF);
+
+    // Don't resume from whatever state the section held when it was skipped
+    if (isNowActive && !s.active) {
+      s.direct.reset();
+      s.svf.m1 = s.svf.m2 = 0.0;
+    }
+
+    s.active = isNowActive;
+    if (isNowActive)
+      activeList[(size_t)numActive++] = i;
+  }
+
+  activeListDirty = false;
+}
+
+BiquadCascade::Snapshot BiquadCascade::getSnapshot() const {
+  Snapshot snapshot;
+  for (size_t i = 0; i < sections.size(); ++i) {
+    snapshot.designs[i] = sections[i].target;
+    snapshot.enabled[i] = sections[i].enabled;
+  }
+  return snapshot;
+}
+
+bool BiquadCascade::isGliding() const {
+  return std::any_of(sections.begin(), sections.end(), [](const auto &s) {
+    return s.enabled && (s.glideSteps > 0 || s.useSVF);
+  });
+}
+
+void BiquadCascade::processOffline(const Snapshot &snapshot,
+                                   double sampleRate, float *data,
+                                   int numSamples) {
+  juce::dsp::AudioBlock<float> block(&data, 1, (size_t)numSamples);
+
+  for (size_t i = 0; i < snapshot.designs.size(); ++i) {
+    const auto &d = snapshot.designs[i];
+    if (!snapshot.enabled[i] || isUnity(d))
+      continue;
+
+    BiquadFilter filter;
+    filter.setCoefficients(
+        calculateBiquadCoeffs(d.frequency, d.q, d.gainDB, d.type, sampleRate));
+    filter.process(block);
+  }
+}
+
+//==============================================================================
+template <size_t NumFused>
+void BiquadCascade::processFused(DirectFilter *const *filters, StereoVec *data,
+                                 int numSamples) noexcept {
+  static_assert(NumFused > 0);
+  std::array<StereoVec, NumFused> b0, b1, b2, a1, a2, z1, z2;
+
+  for (size_t k = 0; k < NumFused; ++k) {
+    const auto &f = *filters[k];
+    b0[k] = f.b[0], b1[k] = f.b[1], b2[k] = f.b[2];
+    a1[k] = f.a[1], a2[k] = f.a[2];
+    z1[k] = f.z[0][1], z2[k] = f.z[0][2];
+  }
+
+  // The same transposed Direct Form II as chowdsp::IIRFilter, so the
+  // result is identical to one pass per section
+  for (int i = 0; i < numSamples; ++i) {
+    auto x = data[i];
+    for (size_t k = 0; k < NumFused; ++k) {
+      const auto y = z1[k] + x * b0[k];
+      z1[k] = z2[k] + x * b1[k] - y * a1[k];
+      z2[k] = x * b2[k] - y * a2[k];
+      x = y;
+    }
+    data[i] = x;
+  }
+
+  for (size_t k = 0; k < NumFused; ++k) {
+    filters[k]->z[0][1] = z1[k];
+    filters[k]->z[0][2] = z2[k];
+  }
+}
+
+template <size_t... Index>
+constexpr std::array<BiquadCascade::FusedProcessor, sizeof...(Index)>
+BiquadCascade::makeFusedTable(std::index_sequence<Index...>) {
+  return {&processFused<Index + 1>...};
+}
+
+const std::array<BiquadCascade::FusedProcessor, BiquadCascade::numSections>
+    BiquadCascade::fusedProcessors =
+        makeFusedTable(std::make_index_sequence<numSections>());
+
+void BiquadCascade::processSettled(int first, int last, StereoVec *data,
+                                   int numSamples) noexcept {
+  std::array<DirectFilter *, numSections> filters;
+  for (int n = first; n <= last; ++n)
+    filters[(size_t)(n - first)] =
+        &sections[(size_t)activeList[(size_t)n]].direct;
+
+  fusedProcessors[(size_t)(last - first)](filters.data(), data, numSamples);
+}
+
+void BiquadCascade::processGliding(SectionState &s, StereoVec *data,
+                                   int numSamples) noexcept {
+  for (int start = 0; start < numSamples; start += controlInterval) {
+    if (s.glideSteps > 0)
+      advanceGlide(s);
+
+    const auto end = juce::jmin(numSamples, start + controlInterval);
+    for (int i = start; i < end; ++i)
+      data[i] = s.svf.processSample(data[i]);
+  }
+
+  if (s.glideSteps == 0)
+    finishGlide(s);
+}
+
+void BiquadCascade::process(const juce::dsp::AudioBlock<float> &block) noexcept {
+  if (activeListDirty)
+    updateActiveSections();
+
+  if (numActive == 0)
+    return;
+
+  const auto numSamples = (int)block.getNumSamples();
+  jassert(numSamples <= (int)interleaved.size());
+
+  auto *left = block.getChannelPointer(0);
+  auto *right = block.getNumChannels() > 1 ? block.getChannelPointer(1)
+                                           : nullptr;
+
+  auto *data = interleaved.data();
+  for (int i = 0; i < numSamples; ++i)
+    data[i] = StereoVec((double)left[i], right != nullptr ? (double)right[i]
+                                                          : 0.0);
+
+  for (int n = 0; n < numActive; ++n) {
+    auto &s = sections[(size_t)activeList[(size_t)n]];
+
+    if (s.useSVF) {
+      processGliding(s, data, numSamples);
+      continue;
+    }
+
+    // Every settled section up to the next gliding one runs in one pass
+    auto last = n;
+    while (last + 1 < numActive &&
+           !sections[(size_t)activeList[(size_t)(last + 1)]].useSVF)
+      ++last;
+
+    processSettled(n, last, data, numSamples);
+    n = last;
+  }
+
+  for (int i = 0; i < numSamples; ++i) {
+    left[i] = (float)data[i].get(0);
+    if (right != nullptr)
+      right[i] = (float)data[i].get(1);
+  }
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "BiquadFilter.h"
+#include <chowdsp_filters/chowdsp_filters.h>
+#include <chowdsp_simd/chowdsp_simd.h>
+
+//==============================================================================
+/**
+ * Serial cascade of stereo biquad sections for the post-drive tone stack.
+ *
+ * Both channels run in one SIMD register: each sample is a two-lane double
+ * batch (left, right), so every section processes the pair with a single
+ * set of vector operations. Sections are chowdsp::IIRFilter instances stored
+ * contiguously. The block is interleaved into a buffer allocated in
+ * prepare(), then each active section makes one tight pass over it.
+ *
+ * Sections that are disabled, or whose coefficients reduce to unity (0 dB
+ * shelves/peaks), are skipped. A skipped section's state is cleared when it
+ * comes back.
+ *
+ * Settled sections run fused: one pass over the block carries the sample
+ * through every section in turn, so the sections' recursions overlap rather
+ * than each waiting on its own. The pass is instantiated for every section
+ * count and picked from a table per block, so the loop over sections is
+ * unrolled with its coefficients and state held in registers.
+ *
+ * Coefficients are only recomputed for the section whose design changed.
+ * While a section glides to a new design it runs as a state variable filter
+ * (the topology used by chowdsp::ModFilterWrapper). That filter stays well
+ * behaved when its coefficients move every few samples. The section returns
+ * to Direct Form II once settled, and its state is carried across each
+ * switch.
+ */
+class BiquadCascade {
+public:
+  using StereoVec = xsimd::make_sized_batch_t<double, 2>;
+  static_assert(!std::is_void_v<StereoVec>,
+                "Target has no two-lane double SIMD type");
+
+  static constexpr int maxChannels = 2;
+
+  // Design changes glide over this time, updated every controlInterval
+  static constexpr double glideSeconds = 0.02;
+  static constexpr int controlInterval = 32;
+
+  // Section order is processing order
+  enum Section {
+    LowBoost = 0,
+    Bass,
+    Mid,
+    Treble,
+    Presence,
+    Peq1,
+    Peq2,
+    Peq3,
+    Peq4,
+    LofiLowPass,
+    LofiHighPass,
+    numSections
+  };
+
+  struct Design {
+    BiquadType type = BiquadType::Peaking;
+    float frequency = 1000.0f;
+    float q = 1.0f;
+    float gainDB = 0.0f;
+
+    bool operator==(const Design &other) const {
+      return type == other.type &&
+             juce::exactlyEqual(frequency, other.frequency) &&
+             juce::exactlyEqual(q, other.q) &&
+             juce::exactlyEqual(gainDB, other.gainDB);
+    }
+    bool operator!=(const Design &other) const { return !(*this == other); }
+  };
+
+  // Settled design and enable state of every section
+  struct Snapshot {
+    std::array<Design, numSections> designs;
+    std::array<bool, numSections> enabled{};
+
+    bool operator==(const Snapshot &other) const {
+      return designs == other.designs && enabled == other.enabled;
+    }
+    bool operator!=(const Snapshot &other) const { return !(*this == other); }
+  };
+
+  // 0 dB shelves and peaks pass the signal through unchanged
+  static bool isUnity(const Design &d) {
+    return juce::exactlyEqual(d.gainDB, 0.0f) &&
+           d.type != BiquadType::LowPass && d.type != BiquadType::HighPass;
+  }
+
+  void prepare(double sampleRate, int maxBlockSize);
+  void reset();
+
+  // Cheap when nothing changed; call once per block for every section
+  void setDesign(Section section, const Design &design);
+  void setEnabled(Section section, bool shouldBeEnabled);
+
+  bool isActive(Section section) const {
+    return sections[(size_t)section].active;
+  }
+
+  void process(const juce::dsp::AudioBlock<float> &block) noexcept;
+
+  // What the cascade sounds like once every glide has finished
+  Snapshot getSnapshot() const;
+
+  // True while any section is still moving towards its target
+  bool isGliding() const;
+
+  // Filters a mono buffer through a snapshot's sections, from silence. Not
+  // for the audio thread.
+  static void processOffline(const Snapshot &snapshot, double sampleRate,
+                             float *data, int numSamples);
+
+private:
+  // State variable form of a biquad; see chowdsp::ModFilterWrapper
+  struct SVF {
+    void setCoefficients(const BiquadCoeffs &c) noexcept;
+    StereoVec processSample(StereoVec x) noexcept;
+
+    // Maps Direct Form II state to and from this form with the same
+    // zero-input response, so topology switches don't click
+    void setStateFrom(const chowdsp::IIRFilter<2, StereoVec> &filter) noexcept;
+    void copyStateTo(chowdsp::IIRFilter<2, StereoVec> &filter,
+                     const BiquadCoeffs &c) const noexcept;
+
+    double g = 0.0, g2 = 0.0, twoGSqr = 0.0, h = 0.0, R2 = 0.0;
+    double c0 = 1.0, c1 = 0.0, c2 = 0.0;
+    StereoVec m1 = 0.0, m2 = 0.0;
+  };
+
+  using DirectFilter = chowdsp::IIRFilter<2, StereoVec>;
+
+  // Runs NumFused settled sections over the block in a single pass
+  template <size_t NumFused>
+  static void processFused(DirectFilter *const *filters, StereoVec *data,
+                           int numSamples) noexcept;
+
+  using FusedProcessor = void (*)(DirectFilter *const *, StereoVec *,
+                                  int) noexcept;
+  template <size_t... Index>
+  static constexpr std::array<FusedProcessor, sizeof...(Index)>
+  makeFusedTable(std::index_sequence<Index...>);
+
+  // Indexed by the number of sections minus one
+  static const std::array<FusedProcessor, numSections> fusedProcessors;
+
+  struct SectionState {
+    chowdsp::IIRFilter<2, StereoVec> direct;
+    SVF svf;
+
+    Design current, target, glideStart;
+    BiquadCoeffs coeffs; // For the current design
+    int glideStep = 0, glideSteps = 0;
+
+    bool enabled = false, targetIsUnity = true, active = false;
+    bool useSVF = false;
+  };
+
+  void setCoefficients(SectionState &s, const Design &design);
+  void advanceGlide(SectionState &s);
+  void startGlide(SectionState &s, const Design &newTarget);
+  void finishGlide(SectionState &s);
+  void processGliding(SectionState &s, StereoVec *data,
+                      int numSamples) noexcept;
+  // The active sections from first to last, none of them gliding
+  void processSettled(int first, int last, StereoVec *data,
+                      int numSamples) noexcept;
+  void updateActiveSections();
+
+  double fs = 0.0;
+  int glideTicks = 1;
+
+  std::array<SectionState, numSections> sections;
+
+  // Indices of the sections to run, in order
+  std::array<int, numSections> activeList{};
+  int numActive = 0;
+  bool activeListDirty = false;
+
+  std::vector<StereoVec> interleaved;
+};
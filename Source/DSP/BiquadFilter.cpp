@@ -0,0 +1,77 @@
+#include "BiquadFilter.h"
+#include <chowdsp_math/chowdsp_math.h>
+
+BiquadCoeffs calculateBiquadCoeffs(float frequency, float Q, float gainDB,
+                                   BiquadType type, double sampleRate) {
+  // Keep the centre frequency below Nyquist so high-Q bands stay stable
+  frequency = juce::jlimit(1.0f, (float)(sampleRate * 0.49), frequency);
+
+  // Recomputed at control rate while a section glides, so use the chowdsp
+  // approximations (max error ~1e-7 for sin/cos, ~1e-4 relative for pow)
+  const float w0 = juce::MathConstants<float>::twoPi * frequency /
+                   (float)sampleRate;
+  const auto [sinW0, cosW0] =
+      chowdsp::TrigApprox::sin_cos_3angle_mpi_pi<7, 6>(w0);
+  const float A = chowdsp::PowApprox::pow10(gainDB / 40.0f);
+  const float sqrtA = std::sqrt(A);
+
+  float alpha, b0, b1, b2, a0, a1, a2;
+
+  switch (type) {
+  case BiquadType::LowShelf: {
+    alpha = sinW0 / 2.0f *
+            std::sqrt((A + 1.0f / A) * (1.0f / 0.707f - 1.0f) + 2.0f);
+    b0 = A * ((A + 1) - (A - 1) * cosW0 + 2 * sqrtA * alpha);
+    b1 = 2 * A * ((A - 1) - (A + 1) * cosW0);
+    b2 = A * ((A + 1) - (A - 1) * cosW0 - 2 * sqrtA * alpha);
+    a0 = (A + 1) + (A - 1) * cosW0 + 2 * sqrtA * alpha;
+    a1 = -2 * ((A - 1) + (A + 1) * cosW0);
+    a2 = (A + 1) + (A - 1) * cosW0 - 2 * sqrtA * alpha;
+    break;
+  }
+  case BiquadType::HighShelf: {
+    alpha = sinW0 / 2.0f *
+            std::sqrt((A + 1.0f / A) * (1.0f / 0.707f - 1.0f) + 2.0f);
+    b0 = A * ((A + 1) + (A - 1) * cosW0 + 2 * sqrtA * alpha);
+    b1 = -2 * A * ((A - 1) + (A + 1) * cosW0);
+    b2 = A * ((A + 1) + (A - 1) * cosW0 - 2 * sqrtA * alpha);
+    a0 = (A + 1) - (A - 1) * cosW0 + 2 * sqrtA * alpha;
+    a1 = 2 * ((A - 1) - (A + 1) * cosW0);
+    a2 = (A + 1) - (A - 1) * cosW0 - 2 * sqrtA * alpha;
+    break;
+  }
+  case BiquadType::LowPass: {
+    alpha = sinW0 / (2.0f * Q);
+    b0 = (1 - cosW0) / 2;
+    b1 = 1 - cosW0;
+    b2 = (1 - cosW0) / 2;
+    a0 = 1 + alpha;
+    a1 = -2 * cosW0;
+    a2 = 1 - alpha;
+    break;
+  }
+  case BiquadType::HighPass: {
+    alpha = sinW0 / (2.0f * Q);
+    b0 = (1 + cosW0) / 2;
+    b1 = -(1 + cosW0);
+    b2 = (1 + cosW0) / 2;
+    a0 = 1 + alpha;
+    a1 = -2 * cosW0;
+    a2 = 1 - alpha;
+    break;
+  }
+  case BiquadType::Peaking:
+  default: {
+    alpha = sinW0 / (2.0f * Q);
+    b0 = 1 + alpha * A;
+    b1 = -2 * cosW0;
+    b2 = 1 - alpha * A;
+    a0 = 1 + alpha / A;
+    a1 = -2 * cosW0;
+    a2 = 1 - alpha / A;
+    break;
+  }
+  }
+
+  return {b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0};
+}
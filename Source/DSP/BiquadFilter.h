@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+// Filter shapes used by the web engine (see JUCE_PORTING_GUIDE.md)
+enum class BiquadType { LowShelf, HighShelf, Peaking, LowPass, HighPass };
+
+struct BiquadCoeffs {
+  float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f; // Feedforward
+  float a1 = 0.0f, a2 = 0.0f;            // Feedback (a0 normalized to 1)
+};
+
+// RBJ cookbook coefficients, matching calculateBiquadCoeffs in the worklet
+BiquadCoeffs calculateBiquadCoeffs(float frequency, float Q, float gainDB,
+                                   BiquadType type, double sampleRate);
+
+//==============================================================================
+/**
+ * Stereo biquad section (Transposed Direct Form II).
+ * Holds one set of coefficients and independent state per channel.
+ */
+class BiquadFilter {
+public:
+  static constexpr int maxChannels = 2;
+
+  void setCoefficients(const BiquadCoeffs &newCoeffs) { coeffs = newCoeffs; }
+  const BiquadCoeffs &getCoefficients() const { return coeffs; }
+
+  void reset() {
+    for (auto &s : state)
+      s = {};
+  }
+
+  void process(const juce::dsp::AudioBlock<float> &block) {
+    const auto numSamples = (int)block.getNumSamples();
+    const auto numChannels =
+        juce::jmin((int)block.getNumChannels(), maxChannels);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+      processChannel(block.getChannelPointer((size_t)ch), numSamples,
+                     state[(size_t)ch]);
+  }
+
+private:
+  struct State {
+    float z1 = 0.0f, z2 = 0.0f;
+  };
+
+  void processChannel(float *data, int numSamples, State &s) const noexcept {
+    const auto [b0, b1, b2, a1, a2] = coeffs;
+    auto z1 = s.z1;
+    auto z2 = s.z2;
+
+    for (int i = 0; i < numSamples; ++i) {
+      const auto x = data[i];
+      const auto y = b0 * x + z1;
+      z1 = b1 * x - a1 * y + z2;
+      z2 = b2 * x - a2 * y;
+      data[i] = y;
+    }
+
+    juce::dsp::util::snapToZero(z1);
+    juce::dsp::util::snapToZero(z2);
+    s.z1 = z1;
+    s.z2 = z2;
+  }
+
+  BiquadCoeffs coeffs;
+  std::array<State, maxChannels> state{};
+};
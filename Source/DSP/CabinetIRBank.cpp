@@ -0,0 +1,37 @@
+#include "CabinetIRBank.h"
+
+std::shared_ptr<const CabinetIRBank::Set>
+CabinetIRBank::getSet(double sampleRate, size_t maxBlockSize) {
+  const juce::ScopedLock sl(lock);
+
+  // Drop sets no instance uses any more
+  sets.erase(std::remove_if(sets.begin(), sets.end(),
+                            [](const auto &set) { return set.expired(); }),
+             sets.end());
+
+  for (auto &weak : sets)
+    if (auto set = weak.lock();
+        juce::exactlyEqual(set->sampleRate, sampleRate) &&
+        set->maxBlockSize == maxBlockSize)
+      return set;
+
+  auto set = std::make_shared<Set>();
+  set->sampleRate = sampleRate;
+  set->maxBlockSize = maxBlockSize;
+  set->irLength = CabinetIRs::getLength(sampleRate);
+
+  // Only its layout is used
+  const PartitionedConvolution layout((size_t)set->irLength, maxBlockSize);
+
+  for (int i = 0; i < CabinetIRs::numBuiltIn; ++i) {
+    set->irs[(size_t)i] = CabinetIRs::render(i, sampleRate);
+
+    auto transform =
+        std::make_unique<PartitionedConvolution::IRTransfer>(layout);
+    transform->setNewIR(set->irs[(size_t)i].getReadPointer(0));
+    set->transforms[(size_t)i] = std::move(transform);
+  }
+
+  sets.push_back(set);
+  return set;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CabinetIRs.h"
+#include "PartitionedConvolution.h"
+#include <array>
+#include <memory>
+
+//==============================================================================
+/**
+ * Every built-in cabinet IR, rendered at the session rate and transformed
+ * into the partitions a PartitionedConvolution of that layout expects.
+ *
+ * One bank is shared by every plugin instance in the process (hold it in a
+ * juce::SharedResourcePointer). Each sample rate and block size is built
+ * once, on the first prepare() that asks for it, and kept while any
+ * instance still uses it. Switching cabinets after that is a copy of
+ * ready-made spectra, with no rendering, resampling or FFTs.
+ */
+class CabinetIRBank {
+public:
+  // Immutable once built, so any thread may read it without locking
+  struct Set {
+    double sampleRate = 0.0;
+    size_t maxBlockSize = 0;
+    int irLength = 0;
+
+    // Time-domain IRs, for folding tone into them
+    std::array<juce::AudioBuffer<float>, CabinetIRs::numBuiltIn> irs;
+    std::array<std::unique_ptr<PartitionedConvolution::IRTransfer>,
+               CabinetIRs::numBuiltIn>
+        transforms;
+
+    const juce::AudioBuffer<float> &getIR(int index) const {
+      return irs[(size_t)juce::jlimit(0, CabinetIRs::numBuiltIn - 1, index)];
+    }
+
+    const PartitionedConvolution::IRTransfer &getTransform(int index) const {
+      return *transforms[(size_t)juce::jlimit(0, CabinetIRs::numBuiltIn - 1,
+                                               index)];
+    }
+  };
+
+  // Message thread: may render the whole set, so never call while
+  // processing audio
+  std::shared_ptr<const Set> getSet(double sampleRate, size_t maxBlockSize);
+
+private:
+  juce::CriticalSection lock;
+  std::vector<std::weak_ptr<const Set>> sets;
+};
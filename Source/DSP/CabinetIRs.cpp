@@ -0,0 +1,93 @@
+#include "CabinetIRs.h"
+#include "BiquadFilter.h"
+
+namespace {
+struct CabinetVoicing {
+  const char *name;
+  float hpFreq, hpQ;                      // cone/port low cut
+  float resFreq, resGainDB, resQ;         // speaker resonance bump
+  float midFreq, midGainDB, midQ;         // mid contour
+  float presFreq, presGainDB, presQ;      // upper-mid cone breakup
+  float lpFreq, lpQ;                      // cone roll-off (applied twice)
+};
+
+// clang-format off
+constexpr CabinetVoicing voicings[CabinetIRs::numBuiltIn] = {
+    {"DJENT CRUSH 4x12", 90.0f, 0.9f, 110.0f, 4.0f, 1.4f, 500.0f, -4.0f, 0.8f, 2800.0f, 5.0f, 1.2f, 5200.0f, 0.8f},
+    {"MESA OVERSIZED",   70.0f, 0.8f,  95.0f, 5.0f, 1.2f, 650.0f, -3.0f, 0.9f, 2400.0f, 3.0f, 1.0f, 4800.0f, 0.8f},
+    {"EVH 5150 III",     85.0f, 0.8f, 120.0f, 3.0f, 1.3f, 800.0f,  1.0f, 1.0f, 3200.0f, 4.0f, 1.4f, 5500.0f, 0.9f},
+    {"ORANGE PPC412",    75.0f, 0.7f, 100.0f, 4.0f, 1.0f, 450.0f,  2.0f, 0.9f, 2000.0f, 2.0f, 1.0f, 4200.0f, 0.7f},
+    {"FRAMUS DRAGON",    60.0f, 0.8f,  80.0f, 4.0f, 1.2f, 700.0f, -2.0f, 0.8f, 3000.0f, 3.0f, 1.2f, 5000.0f, 0.8f},
+    {"DIEZEL FRONTLOAD", 80.0f, 0.9f, 105.0f, 3.0f, 1.4f, 900.0f, -1.0f, 1.0f, 3500.0f, 5.0f, 1.5f, 6000.0f, 0.9f},
+    {"ENGL PRO 4x12",    95.0f, 1.0f, 125.0f, 3.0f, 1.5f, 600.0f, -2.0f, 0.9f, 2600.0f, 4.0f, 1.3f, 5200.0f, 0.8f},
+    {"PEAVEY 5150",      85.0f, 0.9f, 110.0f, 4.0f, 1.3f, 750.0f, -5.0f, 0.7f, 2900.0f, 4.0f, 1.2f, 5000.0f, 0.8f},
+    {"BOGNER UBERCAB",   70.0f, 0.7f,  95.0f, 4.0f, 1.1f, 550.0f,  1.0f, 0.9f, 2200.0f, 3.0f, 1.0f, 4600.0f, 0.7f},
+    {"SOLDANO 4x12",     80.0f, 0.7f, 100.0f, 3.0f, 1.1f, 800.0f,  2.0f, 0.8f, 2500.0f, 2.0f, 1.0f, 4400.0f, 0.7f},
+};
+// clang-format on
+
+const CabinetVoicing &getVoicing(int index) {
+  return voicings[juce::jlimit(0, CabinetIRs::numBuiltIn - 1, index)];
+}
+} // namespace
+
+float CabinetIRs::getPeakMagnitude(const float *ir, int numSamples) {
+  const auto order = juce::jmax(
+      8, (int)std::ceil(std::log2((double)numSamples)) + 1);
+  juce::dsp::FFT fft(order);
+
+  std::vector<float> spectrum((size_t)(2 << order), 0.0f);
+  std::copy(ir, ir + numSamples, spectrum.begin());
+  fft.performFrequencyOnlyForwardTransform(spectrum.data(), true);
+
+  return *std::max_element(spectrum.begin(),
+                           spectrum.begin() + (fft.getSize() / 2 + 1));
+}
+
+int CabinetIRs::getLength(double sampleRate) {
+  return juce::roundToInt(2048.0 * sampleRate / 48000.0);
+}
+
+const char *CabinetIRs::getName(int index) { return getVoicing(index).name; }
+
+juce::AudioBuffer<float> CabinetIRs::render(int index, double sampleRate) {
+  const auto &v = getVoicing(index);
+  const auto length = getLength(sampleRate);
+
+  juce::AudioBuffer<float> ir(1, length);
+  ir.clear();
+  ir.setSample(0, 0, 1.0f);
+
+  const BiquadCoeffs stages[] = {
+      calculateBiquadCoeffs(v.hpFreq, v.hpQ, 0.0f, BiquadType::HighPass,
+                            sampleRate),
+      calculateBiquadCoeffs(v.resFreq, v.resQ, v.resGainDB,
+                            BiquadType::Peaking, sampleRate),
+      calculateBiquadCoeffs(v.midFreq, v.midQ, v.midGainDB,
+                            BiquadType::Peaking, sampleRate),
+      calculateBiquadCoeffs(v.presFreq, v.presQ, v.presGainDB,
+                            BiquadType::Peaking, sampleRate),
+      calculateBiquadCoeffs(v.lpFreq, v.lpQ, 0.0f, BiquadType::LowPass,
+                            sampleRate),
+      calculateBiquadCoeffs(v.lpFreq, v.lpQ, 0.0f, BiquadType::LowPass,
+                            sampleRate),
+  };
+
+  juce::dsp::AudioBlock<float> block(ir);
+  for (const auto &coeffs : stages) {
+    BiquadFilter filter;
+    filter.setCoefficients(coeffs);
+    filter.process(block);
+  }
+
+  // Fade the last 10% so the truncated tail does not click
+  const auto fadeLength = length / 10;
+  ir.applyGainRamp(length - fadeLength, fadeLength, 1.0f, 0.0f);
+
+  // Loudest frequency at 0 dB
+  if (const auto peak = getPeakMagnitude(ir.getReadPointer(0), length);
+      peak > 1.0e-6f)
+    ir.applyGain(1.0f / peak);
+
+  return ir;
+}
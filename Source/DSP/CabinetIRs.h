@@ -0,0 +1,28 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+//==============================================================================
+/**
+ * Built-in cabinet impulse responses (irIndex 0 - 9).
+ *
+ * No recorded captures ship with the plugin yet, so each cabinet is rendered
+ * from a speaker voicing (low resonance, mid contour, presence peak and
+ * cone roll-off) at the requested sample rate. Must not be called from the
+ * audio thread: it allocates.
+ */
+namespace CabinetIRs {
+constexpr int numBuiltIn = 10;
+
+// Length of a built-in cabinet IR at the given sample rate (~43 ms)
+int getLength(double sampleRate);
+
+// Display name matching builtInIRs in shared/schema.ts
+const char *getName(int index);
+
+// Loudest magnitude in the IR's frequency response
+float getPeakMagnitude(const float *ir, int numSamples);
+
+// Renders the mono IR, normalised to 0 dB peak magnitude response
+juce::AudioBuffer<float> render(int index, double sampleRate);
+} // namespace CabinetIRs
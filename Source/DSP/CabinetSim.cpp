@@ -0,0 +1,358 @@
+#include "CabinetSim.h"
+#include "CabinetIRs.h"
+
+namespace {
+constexpr int bakePollMs = 20;
+constexpr double switchFadeSeconds = 0.01;
+
+// Energy the tone may leave past the end of the IR (-60 dB)
+constexpr double maxTailEnergy = 1.0e-6;
+} // namespace
+
+CabinetSim::CabinetSim() { bakeThread.addTimeSliceClient(this); }
+
+CabinetSim::~CabinetSim() {
+  bakeThread.removeTimeSliceClient(this);
+  releaseCustomIRs();
+  bakeThread.stopThread(1000);
+}
+
+void CabinetSim::prepare(double sampleRate, int maxBlockSize,
+                         int numChannels) {
+  auto set = bank->getSet(sampleRate, (size_t)maxBlockSize);
+  const auto irLength = (size_t)set->irLength;
+  plainIndex = requestedIndex;
+
+  for (int ch = 0; ch < maxChannels; ++ch) {
+    const bool used = ch < numChannels;
+    engines[(size_t)ch] = used ? std::make_unique<PartitionedConvolution>(
+                                     irLength, (size_t)maxBlockSize)
+                               : nullptr;
+    switchEngines[(size_t)ch] =
+        used ? std::make_unique<PartitionedConvolution>(
+                   irLength, (size_t)maxBlockSize)
+             : nullptr;
+
+    if (used)
+      set->getTransform(plainIndex).transferIR(*engines[(size_t)ch]);
+  }
+
+  fadeLength = juce::roundToInt(switchFadeSeconds * sampleRate);
+  switchBuffer.setSize(maxChannels, maxBlockSize);
+
+  {
+    const juce::ScopedLock sl(bakeLock);
+    fs = sampleRate;
+    irSet = std::move(set);
+    foldTransfer =
+        std::make_unique<PartitionedConvolution::IRTransfer>(*engines[0]);
+    ++cabinetVersion;
+  }
+
+  usingToneFold = false;
+  switching = false;
+  lastCabinetVersion = -1;
+
+  releaseCustomIRs();
+  loader.prepare(sampleRate, maxBlockSize, numChannels);
+
+  if (!bakeThread.isThreadRunning())
+    bakeThread.startThread(juce::Thread::Priority::low);
+}
+
+int CabinetSim::getMemoryLength() const {
+  auto length = irSet != nullptr ? irSet->irLength : 0;
+  for (const auto *cabinet : {customIR, playing, fadingOut})
+    if (cabinet != nullptr)
+      length = juce::jmax(length, cabinet->length);
+  return length;
+}
+
+void CabinetSim::reset() {
+  // The incoming engines already hold the target IR
+  if (sourceFading)
+    finishSourceFade();
+  if (switching)
+    finishSwitch();
+
+  for (auto *engineSet : {&engines, &switchEngines})
+    for (auto &engine : *engineSet)
+      if (engine != nullptr)
+        engine->reset();
+
+  if (playing != nullptr)
+    playing->reset();
+
+  processingMono = false;
+}
+
+void CabinetSim::setIRIndex(int index) {
+  requestedIndex = juce::jlimit(0, CabinetIRs::numBuiltIn - 1, index);
+}
+
+void CabinetSim::processEngines(EngineSet &engineSet,
+                                juce::dsp::AudioBlock<float> &block) {
+  const auto numSamples = block.getNumSamples();
+  const auto numChannels =
+      processingMono ? (size_t)1
+                     : juce::jmin(block.getNumChannels(), (size_t)maxChannels);
+
+  for (size_t ch = 0; ch < numChannels; ++ch) {
+    if (auto &engine = engineSet[ch]; engine != nullptr) {
+      auto *data = block.getChannelPointer(ch);
+      engine->processSamples(data, data, numSamples);
+    }
+  }
+
+  if (processingMono)
+    block.getSingleChannelBlock(1).copyFrom(block.getSingleChannelBlock(0));
+}
+
+void CabinetSim::startSwitch(const PartitionedConvolution::IRTransfer &ir,
+                             bool toggleToneFold) {
+  // The input history doesn't depend on the IR, so the incoming engines
+  // produce the new IR's output from the first sample
+  for (size_t ch = 0; ch < (size_t)maxChannels; ++ch) {
+    if (auto &engine = switchEngines[ch]; engine != nullptr) {
+      ir.transferIR(*engine);
+      engine->copyStateFrom(*engines[ch]);
+    }
+  }
+
+  switching = true;
+  togglesToneFold = toggleToneFold;
+  fadeRemaining = fadeLength;
+}
+
+bool CabinetSim::advanceFade(juce::dsp::AudioBlock<float> &block,
+                             const juce::dsp::AudioBlock<float> &incoming) {
+  const auto numSamples = (int)block.getNumSamples();
+
+  for (size_t ch = 0; ch < block.getNumChannels(); ++ch) {
+    auto *out = block.getChannelPointer(ch);
+    const auto *in = incoming.getChannelPointer(ch);
+
+    for (int i = 0; i < numSamples; ++i) {
+      const auto t = juce::jmin(
+          1.0f, (float)(fadeLength - fadeRemaining + i + 1) / (float)fadeLength);
+      out[i] += t * (in[i] - out[i]);
+    }
+  }
+
+  fadeRemaining -= numSamples;
+  return fadeRemaining <= 0;
+}
+
+void CabinetSim::finishSwitch() {
+  std::swap(engines, switchEngines);
+  if (togglesToneFold)
+    usingToneFold = !usingToneFold;
+  switching = false;
+}
+
+void CabinetSim::updateSource() {
+  if (auto *cabinet = loader.takeLoaded()) {
+    if (customIR != playing && customIR != fadingOut)
+      loader.retire(customIR);
+    customIR = cabinet;
+  }
+
+  auto *target = useCustomIR ? customIR : nullptr;
+  if (sourceFading || target == playing)
+    return;
+
+  // Wait for the built-in side to settle on a plain IR, so both sides of
+  // the fade share the live tone filters
+  if (playing == nullptr && (switching || usingToneFold))
+    return;
+
+  // The outgoing engines' history is of no use to the other side, which
+  // has been idle
+  if (target != nullptr) {
+    target->reset();
+  } else {
+    plainIndex = requestedIndex;
+    for (auto &engine : engines) {
+      if (engine != nullptr) {
+        irSet->getTransform(plainIndex).transferIR(*engine);
+        engine->reset();
+      }
+    }
+  }
+
+  fadingOut = playing;
+  playing = target;
+  sourceFading = true;
+  fadeRemaining = fadeLength;
+}
+
+void CabinetSim::finishSourceFade() {
+  if (fadingOut != customIR)
+    loader.retire(fadingOut);
+  fadingOut = nullptr;
+  sourceFading = false;
+}
+
+bool CabinetSim::isStereo() const {
+  auto *target = useCustomIR ? customIR : nullptr;
+  for (const auto *cabinet : {target, playing, fadingOut})
+    if (cabinet != nullptr && cabinet->stereo)
+      return true;
+  return false;
+}
+
+void CabinetSim::syncChannels() {
+  // The right engines saw the same input until they were skipped, and the
+  // left ones have kept going since
+  auto sync = [](EngineSet &engineSet) {
+    if (engineSet[0] != nullptr && engineSet[1] != nullptr)
+      engineSet[1]->copyStateFrom(*engineSet[0]);
+  };
+
+  sync(engines);
+  if (switching)
+    sync(switchEngines);
+  for (auto *cabinet : {playing, fadingOut})
+    if (cabinet != nullptr)
+      sync(cabinet->engines);
+}
+
+void CabinetSim::releaseCustomIRs() {
+  if (fadingOut != customIR && fadingOut != playing)
+    loader.retire(fadingOut);
+  if (playing != customIR)
+    loader.retire(playing);
+  loader.retire(customIR);
+
+  customIR = playing = fadingOut = nullptr;
+  sourceFading = false;
+}
+
+//==============================================================================
+void CabinetSim::requestToneFold(const ToneFold &tone) {
+  const auto version = cabinetVersion.load(std::memory_order_acquire);
+  if (tone == lastTone && requestedIndex == lastIndex &&
+      version == lastCabinetVersion)
+    return;
+
+  // The baking thread hasn't picked up the previous request yet
+  if (foldRequested.load(std::memory_order_acquire))
+    return;
+
+  requestedTone = tone;
+  requestedFoldIndex = requestedIndex;
+  requestedId = ++lastId;
+  lastTone = tone;
+  lastIndex = requestedIndex;
+  lastCabinetVersion = version;
+  foldRequested.store(true, std::memory_order_release);
+}
+
+bool CabinetSim::hasToneFold(const ToneFold &tone) const {
+  return tone == lastTone && requestedIndex == lastIndex &&
+         foldId.load(std::memory_order_acquire) == lastId &&
+         foldCabinetVersion.load(std::memory_order_relaxed) ==
+             cabinetVersion.load(std::memory_order_relaxed) &&
+         foldUsable.load(std::memory_order_relaxed);
+}
+
+void CabinetSim::setUseToneFold(bool shouldUse) {
+  if (shouldUse && isCustomIRActive())
+    return;
+
+  if (switching) {
+    // The plain IR is still playing with live filters, so a switch to the
+    // baked IR can be abandoned at any point
+    if (!shouldUse && !usingToneFold && togglesToneFold)
+      switching = false;
+    return;
+  }
+
+  if (shouldUse == usingToneFold || foldTransfer == nullptr)
+    return;
+
+  if (!shouldUse) {
+    plainIndex = requestedIndex;
+    startSwitch(irSet->getTransform(plainIndex), true);
+    return;
+  }
+
+  juce::SpinLock::ScopedTryLockType lock(foldTransfer->mutex);
+  if (lock.isLocked())
+    startSwitch(*foldTransfer, true);
+}
+
+void CabinetSim::dropToneFold() {
+  if (sourceFading)
+    finishSourceFade();
+  if (playing != nullptr)
+    return;
+
+  if (switching)
+    finishSwitch();
+
+  if (!usingToneFold && plainIndex == requestedIndex)
+    return;
+
+  plainIndex = requestedIndex;
+  for (auto &engine : engines)
+    if (engine != nullptr)
+      irSet->getTransform(plainIndex).transferIR(*engine);
+
+  usingToneFold = false;
+}
+
+int CabinetSim::useTimeSlice() {
+  if (!foldRequested.load(std::memory_order_acquire))
+    return bakePollMs;
+
+  const auto tone = requestedTone;
+  const auto id = requestedId;
+  const auto index = requestedFoldIndex;
+  foldRequested.store(false, std::memory_order_release);
+
+  const juce::ScopedLock sl(bakeLock);
+  const auto version = cabinetVersion.load();
+
+  juce::AudioBuffer<float> baked;
+  const bool usable =
+      foldTransfer != nullptr && irSet != nullptr &&
+      bakeToneFold(tone, fs, irSet->getIR(index), baked);
+  if (usable)
+    foldTransfer->setNewIR(baked.getReadPointer(0));
+
+  foldUsable.store(usable, std::memory_order_relaxed);
+  foldCabinetVersion.store(version, std::memory_order_relaxed);
+  foldId.store(id, std::memory_order_release);
+
+  return bakePollMs;
+}
+
+bool CabinetSim::bakeToneFold(const ToneFold &tone, double sampleRate,
+                              const juce::AudioBuffer<float> &ir,
+                              juce::AudioBuffer<float> &dest) {
+  const auto length = ir.getNumSamples();
+
+  // Leave room for the filters to ring out so the cut can be measured
+  juce::AudioBuffer<float> padded(1, 2 * length);
+  padded.clear();
+  padded.copyFrom(0, 0, ir, 0, 0, length);
+
+  BiquadCascade::processOffline(tone.filters, sampleRate,
+                                padded.getWritePointer(0), 2 * length);
+  padded.applyGain(tone.gain);
+
+  const auto *data = padded.getReadPointer(0);
+  double kept = 0.0, tail = 0.0;
+  for (int i = 0; i < 2 * length; ++i)
+    (i < length ? kept : tail) += (double)data[i] * (double)data[i];
+
+  // Long resonances (e.g. a narrow low PEQ boost) can't be truncated to
+  // the IR length; those stay on the live filters
+  if (tail > maxTailEnergy * (kept + tail))
+    return false;
+
+  dest.setSize(1, length);
+  dest.copyFrom(0, 0, padded, 0, 0, length);
+  return true;
+}
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "BiquadCascade.h"
+#include "CabinetIRBank.h"
+#include "CustomIRLoader.h"
+#include <array>
+#include <atomic>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+ * Cabinet IR convolution.
+ *
+ * Uses a zero-latency PartitionedConvolution per channel, so long IRs keep
+ * their tail off the audio thread. The built-in IRs come ready-transformed
+ * from a CabinetIRBank shared by every instance. A cabinet change on the
+ * audio thread copies the new spectra into a spare set of engines, gives
+ * them the current engines' input history and crossfades, so it never
+ * blocks or allocates.
+ *
+ * The static post-drive EQ can also be folded into the IR. A background
+ * thread filters the cabinet IR through a requested tone and transforms the
+ * result into a second IRTransfer. Switching between the plain and the baked
+ * IR goes through the same crossfade. Whichever output comes from the plain
+ * IR gets the live tone filters, so both sides of the fade sound the same.
+ *
+ * A custom IR from the CustomIRLoader replaces the built-in cabinet through
+ * a second crossfade. Its engines start empty, so its tail builds up from
+ * the switch on. Tone folding only applies to the built-in cabinets.
+ *
+ * With dual-mono input, the engines run on the left channel only and the
+ * result is copied to the right, unless a stereo custom IR is in use.
+ */
+class CabinetSim : private juce::TimeSliceClient {
+public:
+  static constexpr int maxChannels = 2;
+
+  // Linear, time-invariant processing that can be folded into the IR
+  struct ToneFold {
+    BiquadCascade::Snapshot filters;
+    float gain = 1.0f;
+
+    bool operator==(const ToneFold &other) const {
+      return filters == other.filters && juce::exactlyEqual(gain, other.gain);
+    }
+    bool operator!=(const ToneFold &other) const { return !(*this == other); }
+  };
+
+  CabinetSim();
+  ~CabinetSim() override;
+
+  void prepare(double sampleRate, int maxBlockSize, int numChannels);
+  void reset();
+
+  // Audio thread: selects a built-in cabinet. Cheap to call every block; a
+  // change crossfades on the next process().
+  void setIRIndex(int index);
+
+  // Message thread: imports an IR file in the background
+  void loadCustomIR(const juce::File &file,
+                    const CustomIRLoader::Options &options = {}) {
+    loader.load(file, options);
+  }
+
+  const CustomIRLoader &getCustomIRLoader() const { return loader; }
+
+  // Audio thread: plays the custom IR, once one is loaded, instead of the
+  // built-in cabinet. A change crossfades on the next process().
+  void setUseCustomIR(bool shouldUse) { useCustomIR = shouldUse; }
+
+  // True while a custom IR plays or is wanted; tone folding then stays off
+  bool isCustomIRActive() const {
+    return playing != nullptr || sourceFading ||
+           (useCustomIR && customIR != nullptr);
+  }
+
+  // Samples of input the output depends on
+  int getMemoryLength() const;
+
+  // applyLiveTone(block) is called on the output of the plain IR whenever
+  // the live tone filters are needed (see isToneLive()). dualMono promises
+  // that both input channels are identical, and have been for at least
+  // getMemoryLength() samples.
+  template <typename LiveTone>
+  void process(juce::dsp::AudioBlock<float> &block, LiveTone &&applyLiveTone,
+               bool dualMono = false);
+
+  // Audio thread: asks the background thread to bake this tone into the IR.
+  // Cheap to call every block; repeated requests are ignored.
+  void requestToneFold(const ToneFold &tone);
+
+  // Audio thread: true once a baked IR for this tone and the current cabinet
+  // is ready to use
+  bool hasToneFold(const ToneFold &tone) const;
+
+  // Audio thread: starts moving to the baked or the plain IR. Retried on
+  // later blocks if the IR is being written to or a switch is underway.
+  void setUseToneFold(bool shouldUse);
+
+  // Audio thread, cabinet bypassed: returns to the plain IR of the selected
+  // cabinet immediately
+  void dropToneFold();
+
+  // True while the baked IR is in use or being switched to or from
+  bool isToneFoldActive() const {
+    return usingToneFold || (switching && togglesToneFold);
+  }
+
+  // True while the plain IR's output needs the live tone filters
+  bool isToneLive() const { return !usingToneFold || switching; }
+
+private:
+  using EngineSet = CustomIRLoader::EngineSet;
+
+  void processEngines(EngineSet &engineSet,
+                      juce::dsp::AudioBlock<float> &block);
+
+  // Loads the IR into the spare engines and starts the crossfade to them
+  void startSwitch(const PartitionedConvolution::IRTransfer &ir,
+                   bool toggleToneFold);
+  void finishSwitch();
+
+  // Takes over a newly loaded custom IR, and starts the crossfade between
+  // it and the built-in cabinet once the built-in side plays a plain IR
+  void updateSource();
+  void finishSourceFade();
+
+  // Hands every custom IR back to the loader
+  void releaseCustomIRs();
+
+  // True while a custom IR with different left and right IRs is in use
+  bool isStereo() const;
+
+  // Gives the right engines the left ones' state after mono processing
+  void syncChannels();
+
+  // Fades block towards incoming; true once the fade is complete
+  bool advanceFade(juce::dsp::AudioBlock<float> &block,
+                   const juce::dsp::AudioBlock<float> &incoming);
+
+  int useTimeSlice() override;
+
+  // Filters the IR through the tone; false if the result rings past the end
+  static bool bakeToneFold(const ToneFold &tone, double sampleRate,
+                           const juce::AudioBuffer<float> &ir,
+                           juce::AudioBuffer<float> &dest);
+
+  juce::SharedResourcePointer<CabinetIRBank> bank;
+
+  EngineSet engines;
+
+  // Selected cabinet, and the one loaded when the plain IR is in use
+  int requestedIndex = 0, plainIndex = 0;
+
+  // Shared with the baking thread, guarded by bakeLock. The audio thread
+  // never takes this lock; these only change in prepare().
+  juce::CriticalSection bakeLock;
+  double fs = 0.0;
+  std::shared_ptr<const CabinetIRBank::Set> irSet;
+  std::atomic<int> cabinetVersion{0};
+
+  std::unique_ptr<PartitionedConvolution::IRTransfer> foldTransfer;
+  bool usingToneFold = false;
+
+  // Engines for the incoming IR while switching
+  EngineSet switchEngines;
+  juce::AudioBuffer<float> switchBuffer;
+  bool switching = false, togglesToneFold = false;
+  int fadeLength = 0, fadeRemaining = 0;
+
+  // Audio thread: the latest custom IR, the one playing and the one fading
+  // out; nullptr stands for the built-in cabinet. Fades between them never
+  // overlap a switch, so they share the switch buffer and fade counter.
+  CustomIRLoader::Cabinet *customIR = nullptr, *playing = nullptr,
+                          *fadingOut = nullptr;
+  bool useCustomIR = false, sourceFading = false;
+
+  // Only the left engines run; the right ones are brought up to date when
+  // stereo processing resumes
+  bool processingMono = false;
+
+  // Single-slot request from the audio thread: the request fields are only
+  // written while foldRequested is false
+  ToneFold requestedTone;
+  int requestedId = 0, requestedFoldIndex = 0;
+  std::atomic<bool> foldRequested{false};
+
+  // Audio thread bookkeeping for the latest request
+  ToneFold lastTone;
+  int lastId = 0, lastIndex = -1, lastCabinetVersion = -1;
+
+  // Result of the latest bake; foldId is published last
+  std::atomic<int> foldId{0}, foldCabinetVersion{-1};
+  std::atomic<bool> foldUsable{false};
+
+  juce::TimeSliceThread bakeThread{"Cabinet IR"};
+  CustomIRLoader loader{bakeThread};
+};
+
+//==============================================================================
+template <typename LiveTone>
+void CabinetSim::process(juce::dsp::AudioBlock<float> &block,
+                         LiveTone &&applyLiveTone, bool dualMono) {
+  updateSource();
+
+  const bool mono = dualMono && block.getNumChannels() > 1 && !isStereo();
+  if (processingMono && !mono)
+    syncChannels();
+  processingMono = mono;
+
+  if (sourceFading || playing != nullptr) {
+    auto &engineSet = playing != nullptr ? playing->engines : engines;
+
+    if (sourceFading) {
+      auto incoming =
+          juce::dsp::AudioBlock<float>(switchBuffer)
+              .getSubsetChannelBlock(0, block.getNumChannels())
+              .getSubBlock(0, block.getNumSamples());
+      incoming.copyFrom(block);
+
+      processEngines(fadingOut != nullptr ? fadingOut->engines : engines,
+                     block);
+      processEngines(engineSet, incoming);
+      if (advanceFade(block, incoming))
+        finishSourceFade();
+    } else {
+      processEngines(engineSet, block);
+    }
+
+    // Both sides are plain IRs
+    applyLiveTone(block);
+    return;
+  }
+
+  // A baked IR is replaced through setUseToneFold(false) instead
+  if (!switching && !usingToneFold && requestedIndex != plainIndex) {
+    plainIndex = requestedIndex;
+    startSwitch(irSet->getTransform(plainIndex), false);
+  }
+
+  if (!switching) {
+    processEngines(engines, block);
+    if (!usingToneFold)
+      applyLiveTone(block);
+    return;
+  }
+
+  auto incoming =
+      juce::dsp::AudioBlock<float>(switchBuffer)
+          .getSubsetChannelBlock(0, block.getNumChannels())
+          .getSubBlock(0, block.getNumSamples());
+  incoming.copyFrom(block);
+
+  processEngines(engines, block);
+  processEngines(switchEngines, incoming);
+
+  if (togglesToneFold) {
+    applyLiveTone(usingToneFold ? incoming : block);
+    if (advanceFade(block, incoming))
+      finishSwitch();
+  } else {
+    // Both sides are plain IRs, and the tone filters are linear
+    if (advanceFade(block, incoming))
+      finishSwitch();
+    applyLiveTone(block);
+  }
+}
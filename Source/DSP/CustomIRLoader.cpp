@@ -0,0 +1,465 @@
+#include "CustomIRLoader.h"
+#include "CabinetIRs.h"
+#include <complex>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <numeric>
+
+namespace {
+constexpr int pollMs = 20;
+
+// Trimmed silence, relative to the loudest sample
+constexpr float trimThresholdDb = -80.0f;
+
+// Fade applied wherever the tail is cut
+constexpr double cutFadeSeconds = 0.005;
+
+// Floor for the log magnitude, relative to the peak bin (-120 dB)
+constexpr float minPhaseFloor = 1.0e-6f;
+
+juce::AudioBuffer<float> resample(const juce::AudioBuffer<float> &ir,
+                                  double sourceRate, double targetRate) {
+  if (juce::approximatelyEqual(sourceRate, targetRate))
+    return ir;
+
+  const auto ratio = sourceRate / targetRate;
+  const auto length =
+      juce::roundToInt(juce::jmax(1.0, ir.getNumSamples() / ratio));
+
+  // ResamplingAudioSource low-passes when reducing the rate
+  auto original = ir;
+  juce::MemoryAudioSource memorySource(original, false);
+  juce::ResamplingAudioSource resampler(&memorySource, false,
+                                        ir.getNumChannels());
+  resampler.setResamplingRatio(ratio);
+  resampler.prepareToPlay(length, sourceRate);
+
+  juce::AudioBuffer<float> result(ir.getNumChannels(), length);
+  resampler.getNextAudioBlock({&result, 0, length});
+  return result;
+}
+
+float getPeakSample(const juce::AudioBuffer<float> &ir) {
+  float peak = 0.0f;
+  for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+    peak = juce::jmax(peak, ir.getMagnitude(ch, 0, ir.getNumSamples()));
+  return peak;
+}
+
+// Range of samples at or above the threshold, across all channels
+juce::Range<int> getAudibleRange(const juce::AudioBuffer<float> &ir,
+                                 float threshold) {
+  int start = ir.getNumSamples(), end = 0;
+
+  for (int ch = 0; ch < ir.getNumChannels(); ++ch) {
+    const auto *data = ir.getReadPointer(ch);
+    for (int i = 0; i < ir.getNumSamples(); ++i) {
+      if (std::abs(data[i]) >= threshold) {
+        start = juce::jmin(start, i);
+        end = juce::jmax(end, i + 1);
+      }
+    }
+  }
+
+  return start < end ? juce::Range<int>(start, end) : juce::Range<int>();
+}
+
+juce::AudioBuffer<float> copyRange(const juce::AudioBuffer<float> &ir,
+                                   juce::Range<int> range) {
+  juce::AudioBuffer<float> result(ir.getNumChannels(),
+                                  juce::jmax(1, range.getLength()));
+  result.clear();
+  for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+    result.copyFrom(ch, 0, ir, ch, range.getStart(), range.getLength());
+  return result;
+}
+
+// Homomorphic (cepstral) method: folding the real cepstrum onto positive
+// quefrencies gives the minimum-phase IR with the same magnitude response
+void makeMinimumPhase(float *ir, int numSamples) {
+  // Padding keeps the cepstrum from aliasing
+  const auto order = juce::jmax(
+      8, (int)std::ceil(std::log2((double)numSamples)) + 2);
+  juce::dsp::FFT fft(order);
+  const auto size = fft.getSize();
+
+  using Complex = std::complex<float>;
+  std::vector<Complex> a((size_t)size), b((size_t)size);
+  std::fill(a.begin(), a.end(), Complex());
+  for (int i = 0; i < numSamples; ++i)
+    a[(size_t)i] = ir[i];
+
+  fft.perform(a.data(), b.data(), false);
+
+  float peak = 0.0f;
+  for (const auto &bin : b)
+    peak = juce::jmax(peak, std::abs(bin));
+  if (peak <= 0.0f)
+    return;
+
+  const auto floor = peak * minPhaseFloor;
+  for (size_t k = 0; k < b.size(); ++k)
+    a[k] = std::log(juce::jmax(floor, std::abs(b[k])));
+
+  fft.perform(a.data(), b.data(), true);
+
+  // Causal part doubled; n = 0 and the Nyquist term stay as they are
+  for (int n = 1; n < size / 2; ++n)
+    b[(size_t)n] *= 2.0f;
+  for (int n = size / 2 + 1; n < size; ++n)
+    b[(size_t)n] = {};
+
+  fft.perform(b.data(), a.data(), false);
+  for (auto &bin : a)
+    bin = std::exp(bin);
+
+  fft.perform(a.data(), b.data(), true);
+  for (int i = 0; i < numSamples; ++i)
+    ir[i] = b[(size_t)i].real();
+}
+
+// Samples needed to keep all but this fraction of the energy
+int getEnergyLength(const juce::AudioBuffer<float> &ir, double residual) {
+  std::vector<double> energy((size_t)ir.getNumSamples(), 0.0);
+  for (int ch = 0; ch < ir.getNumChannels(); ++ch) {
+    const auto *data = ir.getReadPointer(ch);
+    for (size_t i = 0; i < energy.size(); ++i)
+      energy[i] += (double)data[i] * (double)data[i];
+  }
+
+  const auto total = std::accumulate(energy.begin(), energy.end(), 0.0);
+  auto left = total;
+  for (size_t i = 0; i < energy.size(); ++i) {
+    if (left <= residual * total)
+      return (int)i;
+    left -= energy[i];
+  }
+
+  return (int)energy.size();
+}
+
+void fadeOutEnd(juce::AudioBuffer<float> &ir, double sampleRate) {
+  const auto length = ir.getNumSamples();
+  const auto fadeLength =
+      juce::jmin(length / 10, juce::roundToInt(cutFadeSeconds * sampleRate));
+  if (fadeLength > 0)
+    ir.applyGainRamp(length - fadeLength, fadeLength, 1.0f, 0.0f);
+}
+} // namespace
+
+//==============================================================================
+juce::var CustomIRLoader::Options::toVar() const {
+  auto object = std::make_unique<juce::DynamicObject>();
+  object->setProperty("trimSilence", trimSilence);
+  object->setProperty("normalise", normalise);
+  object->setProperty("minimumPhase", minimumPhase);
+  if (energyCutDb.has_value())
+    object->setProperty("energyCutDb", *energyCutDb);
+  if (truncateDb.has_value())
+    object->setProperty("truncateDb", *truncateDb);
+  return object.release();
+}
+
+CustomIRLoader::Options
+CustomIRLoader::Options::fromVar(const juce::var &object) {
+  Options options;
+
+  auto readFlag = [&](const char *name, bool &flag) {
+    if (object.hasProperty(name))
+      flag = (bool)object[name];
+  };
+  auto readLevel = [&](const char *name, std::optional<float> &level) {
+    const auto value = object[name];
+    if (value.isDouble() || value.isInt() || value.isInt64())
+      level = juce::jmin(0.0f, (float)value);
+  };
+
+  readFlag("trimSilence", options.trimSilence);
+  readFlag("normalise", options.normalise);
+  readFlag("minimumPhase", options.minimumPhase);
+  readLevel("energyCutDb", options.energyCutDb);
+  readLevel("truncateDb", options.truncateDb);
+  return options;
+}
+
+//==============================================================================
+void CustomIRLoader::Cabinet::reset() {
+  for (auto &engine : engines)
+    if (engine != nullptr)
+      engine->reset();
+}
+
+//==============================================================================
+CustomIRLoader::CustomIRLoader(juce::TimeSliceThread &thread_)
+    : thread(thread_) {
+  thread.addTimeSliceClient(this);
+}
+
+CustomIRLoader::~CustomIRLoader() {
+  thread.removeTimeSliceClient(this);
+
+  const juce::ScopedLock sl(lock);
+  delete incoming.exchange(nullptr);
+  collectGarbage();
+}
+
+void CustomIRLoader::prepare(double sampleRate, int maxBlockSize,
+                             int numChannels) {
+  const juce::ScopedLock sl(lock);
+  delete incoming.exchange(nullptr);
+  collectGarbage();
+
+  layout = {sampleRate, maxBlockSize, numChannels};
+  ++generation;
+  buildPending = true;
+}
+
+void CustomIRLoader::load(const juce::File &file, const Options &options) {
+  const juce::ScopedLock sl(lock);
+  pendingFile = file;
+  pendingOptions = options;
+  loadPending = true;
+}
+
+juce::File CustomIRLoader::getLoadedFile() const {
+  const juce::ScopedLock sl(lock);
+  return loadedFile;
+}
+
+CustomIRLoader::Options CustomIRLoader::getLoadedOptions() const {
+  const juce::ScopedLock sl(lock);
+  return loadedOptions;
+}
+
+CustomIRLoader::Report CustomIRLoader::getLastReport() const {
+  const juce::ScopedLock sl(lock);
+  return lastReport;
+}
+
+juce::String CustomIRLoader::getLastError() const {
+  const juce::ScopedLock sl(lock);
+  return lastError;
+}
+
+CustomIRLoader::Cabinet *CustomIRLoader::takeLoaded() noexcept {
+  // Cheap check first; the slot is empty nearly every block
+  if (incoming.load(std::memory_order_relaxed) == nullptr)
+    return nullptr;
+
+  return incoming.exchange(nullptr, std::memory_order_acquire);
+}
+
+void CustomIRLoader::retire(Cabinet *cabinet) noexcept {
+  if (cabinet == nullptr)
+    return;
+
+  // The audio thread holds at most three and gains at most one per time
+  // slice, so no more than four arrive between two collections
+  const auto scope = garbageFifo.write(1);
+  jassert(scope.blockSize1 == 1);
+  if (scope.blockSize1 == 1)
+    garbage[(size_t)scope.startIndex1] = cabinet;
+}
+
+void CustomIRLoader::collectGarbage() {
+  const auto scope = garbageFifo.read(garbageFifo.getNumReady());
+  scope.forEach([this](int index) {
+    delete garbage[(size_t)index];
+    garbage[(size_t)index] = nullptr;
+  });
+}
+
+int CustomIRLoader::useTimeSlice() {
+  juce::File file;
+  Options options;
+  Layout target;
+  int targetGeneration = 0;
+  bool decode = false, rebuild = false;
+
+  {
+    const juce::ScopedLock sl(lock);
+    collectGarbage();
+
+    if (!loadPending && !buildPending)
+      return pollMs;
+
+    file = pendingFile;
+    options = pendingOptions;
+    decode = loadPending;
+    rebuild = buildPending;
+    target = layout;
+    targetGeneration = generation;
+    loadPending = buildPending = false;
+  }
+
+  if (decode) {
+    juce::AudioBuffer<float> decoded;
+    double rate = 0.0;
+    juce::String error;
+
+    if (readFile(file, decoded, rate, error)) {
+      source = std::move(decoded);
+      sourceRate = rate;
+      sourceOptions = options;
+
+      const juce::ScopedLock sl(lock);
+      loadedFile = file;
+      loadedOptions = options;
+      lastError.clear();
+    } else {
+      const juce::ScopedLock sl(lock);
+      lastError = error;
+      importCount.fetch_add(1, std::memory_order_release);
+
+      // Keep the current IR, but still rebuild it at prepare()'s layout
+      if (!rebuild)
+        return pollMs;
+    }
+  }
+
+  // Nothing loaded yet, or not prepared
+  if (source.getNumSamples() == 0 || target.sampleRate <= 0.0 ||
+      target.numChannels <= 0)
+    return pollMs;
+
+  Report report;
+  auto cabinet = build(target, report);
+
+  const juce::ScopedLock sl(lock);
+
+  // prepare() ran meanwhile and asked for a rebuild at its layout
+  if (targetGeneration != generation)
+    return pollMs;
+
+  lastReport = report;
+  importCount.fetch_add(1, std::memory_order_release);
+
+  // A previous IR the audio thread never picked up
+  delete incoming.exchange(cabinet.release(), std::memory_order_acq_rel);
+  return pollMs;
+}
+
+std::unique_ptr<CustomIRLoader::Cabinet>
+CustomIRLoader::build(const Layout &target, Report &report) const {
+  const auto ir = prepareIR(source, sourceRate, target.sampleRate,
+                            sourceOptions, &report);
+
+  auto cabinet = std::make_unique<Cabinet>();
+  cabinet->length = ir.getNumSamples();
+
+  const auto numChannels = juce::jmin(target.numChannels, maxChannels);
+  cabinet->stereo =
+      numChannels > 1 && ir.getNumChannels() > 1 &&
+      std::memcmp(ir.getReadPointer(0), ir.getReadPointer(1),
+                  (size_t)ir.getNumSamples() * sizeof(float)) != 0;
+
+  for (int ch = 0; ch < numChannels; ++ch) {
+    const auto *channelIR =
+        ir.getReadPointer(juce::jmin(ch, ir.getNumChannels() - 1));
+    cabinet->engines[(size_t)ch] = std::make_unique<PartitionedConvolution>(
+        (size_t)cabinet->length, (size_t)target.maxBlockSize, channelIR);
+  }
+
+  return cabinet;
+}
+
+//==============================================================================
+bool CustomIRLoader::readFile(const juce::File &file,
+                              juce::AudioBuffer<float> &dest,
+                              double &sampleRate, juce::String &error) {
+  juce::AudioFormatManager formats;
+  formats.registerBasicFormats();
+
+  std::unique_ptr<juce::AudioFormatReader> reader(
+      formats.createReaderFor(file));
+  if (reader == nullptr) {
+    error = "Can't read " + file.getFileName() + " as audio";
+    return false;
+  }
+
+  if (reader->sampleRate <= 0.0 || reader->lengthInSamples <= 0) {
+    error = file.getFileName() + " is empty";
+    return false;
+  }
+
+  // Leave a second for leading silence; the rest is cut after trimming
+  const auto maxSamples =
+      (juce::int64)((maxLengthSeconds + 1.0) * reader->sampleRate);
+  const auto numSamples = (int)juce::jmin(reader->lengthInSamples, maxSamples);
+  const auto numChannels =
+      juce::jlimit(1, maxChannels, (int)reader->numChannels);
+
+  dest.setSize(numChannels, numSamples);
+  if (!reader->read(&dest, 0, numSamples, 0, true, numChannels > 1)) {
+    error = "Failed to decode " + file.getFileName();
+    return false;
+  }
+
+  sampleRate = reader->sampleRate;
+  return true;
+}
+
+juce::AudioBuffer<float>
+CustomIRLoader::prepareIR(const juce::AudioBuffer<float> &ir,
+                          double sourceRate, double targetRate,
+                          const Options &options, Report *report) {
+  auto result = resample(ir, sourceRate, targetRate);
+  const auto resampledLength = result.getNumSamples();
+
+  // Resampling scales the response by the rate ratio
+  if (!options.normalise)
+    result.applyGain((float)(sourceRate / targetRate));
+
+  const auto peakSample = getPeakSample(result);
+  if (peakSample <= 0.0f) {
+    result.setSize(result.getNumChannels(), 1);
+    result.clear();
+    if (report != nullptr)
+      *report = {resampledLength, 1};
+    return result;
+  }
+
+  if (options.trimSilence) {
+    const auto threshold =
+        peakSample * juce::Decibels::decibelsToGain(trimThresholdDb);
+    result = copyRange(result, getAudibleRange(result, threshold));
+  }
+
+  if (options.minimumPhase)
+    for (int ch = 0; ch < result.getNumChannels(); ++ch)
+      makeMinimumPhase(result.getWritePointer(ch), result.getNumSamples());
+
+  auto cutLength = juce::roundToInt(maxLengthSeconds * targetRate);
+  if (options.energyCutDb.has_value()) {
+    const auto residual =
+        std::pow(10.0, (double)*options.energyCutDb / 10.0);
+    cutLength = juce::jmin(cutLength, getEnergyLength(result, residual));
+  }
+
+  if (options.truncateDb.has_value()) {
+    const auto threshold =
+        peakSample * juce::Decibels::decibelsToGain(*options.truncateDb);
+    cutLength = juce::jmin(cutLength,
+                           getAudibleRange(result, threshold).getEnd());
+  }
+
+  if (cutLength < result.getNumSamples()) {
+    result.setSize(result.getNumChannels(), juce::jmax(1, cutLength), true);
+    fadeOutEnd(result, targetRate);
+  }
+
+  // Loudest frequency of either channel at 0 dB, like the built-in IRs
+  if (options.normalise) {
+    float peak = 0.0f;
+    for (int ch = 0; ch < result.getNumChannels(); ++ch)
+      peak = juce::jmax(peak, CabinetIRs::getPeakMagnitude(
+                                  result.getReadPointer(ch),
+                                  result.getNumSamples()));
+    if (peak > 1.0e-6f)
+      result.applyGain(1.0f / peak);
+  }
+
+  if (report != nullptr)
+    *report = {resampledLength, result.getNumSamples()};
+
+  return result;
+}
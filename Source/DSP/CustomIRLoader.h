@@ -0,0 +1,151 @@
+#pragma once
+
+#include "PartitionedConvolution.h"
+#include <array>
+#include <atomic>
+#include <optional>
+
+//==============================================================================
+/**
+ * Imports user cabinet IRs (the customIRLoaded path) without touching the
+ * audio thread.
+ *
+ * A background thread decodes the file with any format juce_audio_formats
+ * knows, resamples it to the session rate and trims silence. Optionally it
+ * converts the IR to minimum phase and cuts the tail by energy or level.
+ * Then it normalises the IR and builds ready
+ * engines for the result, so every allocation and FFT for a multi-second
+ * room capture happens off the audio thread.
+ *
+ * Finished IRs are handed over through a single atomic slot. The audio
+ * thread takes ownership with takeLoaded() and gives them back through
+ * retire(), a lock-free queue the background thread empties, so it never
+ * frees one either.
+ */
+class CustomIRLoader : private juce::TimeSliceClient {
+public:
+  static constexpr int maxChannels = 2;
+
+  // Longest IR kept after resampling; longer files are cut and faded
+  static constexpr double maxLengthSeconds = 10.0;
+
+  using EngineSet =
+      std::array<std::unique_ptr<PartitionedConvolution>, maxChannels>;
+
+  struct Options {
+    bool trimSilence = true;
+    bool normalise = true;
+
+    // Moves the energy to the front, keeping the magnitude response.
+    // Removes any pre-delay and lets the energy cut take far more.
+    bool minimumPhase = false;
+
+    // Cuts the tail where the energy left after the cut falls this far
+    // below the total (e.g. -40)
+    std::optional<float> energyCutDb;
+
+    // Cuts the tail once it stays this far below the peak (e.g. -60)
+    std::optional<float> truncateDb;
+
+    // As an object for the plugin state and the page; fromVar() keeps the
+    // default for anything missing
+    juce::var toVar() const;
+    static Options fromVar(const juce::var &object);
+  };
+
+  // What the import did to the IR's length
+  struct Report {
+    int resampledLength = 0, finalLength = 0;
+
+    int getTapsSaved() const { return resampledLength - finalLength; }
+  };
+
+  // A custom IR ready to play: mono files feed both channels, stereo files
+  // one channel each
+  struct Cabinet {
+    EngineSet engines;
+    int length = 0;
+    bool stereo = false; // different IRs on the two channels
+
+    // Audio thread
+    void reset();
+  };
+
+  explicit CustomIRLoader(juce::TimeSliceThread &thread);
+  ~CustomIRLoader() override;
+
+  // Message thread, audio stopped: drops everything built for the old
+  // layout and rebuilds the current IR for the new one
+  void prepare(double sampleRate, int maxBlockSize, int numChannels);
+
+  // Any thread: replaces the custom IR once the file is imported
+  void load(const juce::File &file, const Options &options);
+  void load(const juce::File &file) { load(file, Options()); }
+
+  // The file behind the current IR, the options it was imported with, how
+  // the import shortened it, and why the latest load failed (empty if it
+  // didn't)
+  juce::File getLoadedFile() const;
+  Options getLoadedOptions() const;
+  Report getLastReport() const;
+  juce::String getLastError() const;
+
+  // Any thread: goes up whenever an import finishes or fails, so a UI can
+  // poll for a new report without taking the lock
+  int getImportCount() const {
+    return importCount.load(std::memory_order_acquire);
+  }
+
+  // Audio thread: a newly built IR, or nullptr. The caller owns it until it
+  // hands it to retire(), and may hold at most three at once.
+  Cabinet *takeLoaded() noexcept;
+  void retire(Cabinet *cabinet) noexcept;
+
+  // The import pipeline. Never call from the audio thread.
+  static bool readFile(const juce::File &file, juce::AudioBuffer<float> &dest,
+                       double &sampleRate, juce::String &error);
+  static juce::AudioBuffer<float> prepareIR(const juce::AudioBuffer<float> &ir,
+                                            double sourceRate,
+                                            double targetRate,
+                                            const Options &options,
+                                            Report *report = nullptr);
+
+private:
+  struct Layout {
+    double sampleRate = 0.0;
+    int maxBlockSize = 0, numChannels = 0;
+  };
+
+  int useTimeSlice() override;
+
+  std::unique_ptr<Cabinet> build(const Layout &layout, Report &report) const;
+
+  // With lock held
+  void collectGarbage();
+
+  juce::TimeSliceThread &thread;
+
+  // Shared with the background thread; the audio thread never takes it
+  juce::CriticalSection lock;
+  Layout layout;
+  int generation = 0;
+  juce::File pendingFile, loadedFile;
+  Options pendingOptions, loadedOptions;
+  bool loadPending = false, buildPending = false;
+  juce::String lastError;
+  Report lastReport;
+
+  // Background thread: the decoded file, kept to rebuild at a new layout
+  juce::AudioBuffer<float> source;
+  double sourceRate = 0.0;
+  Options sourceOptions;
+
+  std::atomic<Cabinet *> incoming{nullptr};
+  std::atomic<int> importCount{0};
+
+  static constexpr int garbageSize = 8;
+  juce::AbstractFifo garbageFifo{garbageSize};
+  std::array<Cabinet *, garbageSize> garbage{};
+
+  JUCE_DECLARE_NON_COPYABLE(CustomIRLoader)
+};
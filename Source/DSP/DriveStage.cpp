@@ -0,0 +1,149 @@
+#include "DriveStage.h"
+
+namespace {
+using Oversampling = chowdsp::VariableOversampling<float>;
+
+constexpr auto numFactors = 4; // 1x, 2x, 4x, 8x
+constexpr auto numModes = 2;   // IIR, linear phase
+
+// The curve has no memory, so it runs a full SIMD register at a time
+void shapeStateless(float *data, int numSamples, float driveAmount) noexcept {
+  using Vec = xsimd::batch<float>;
+  constexpr auto laneCount = (int)Vec::size;
+
+  int i = 0;
+  for (; i + laneCount <= numSamples; i += laneCount)
+    applyDistortion(Vec::load_unaligned(data + i), driveAmount)
+        .store_unaligned(data + i);
+
+  for (; i < numSamples; ++i)
+    data[i] = applyDistortion(data[i], driveAmount);
+}
+} // namespace
+
+DriveStage::DriveStage(const juce::AudioProcessorValueTreeState &vts)
+    : oversampling(vts, true, "os"),
+      antialiasingParam(vts.getRawParameterValue("driveADAA")) {
+  jassert(antialiasingParam != nullptr); // addParameters() was not called
+}
+
+void DriveStage::addParameters(
+    juce::AudioProcessorValueTreeState::ParameterLayout &layout) {
+  using Factor = Oversampling::OSFactor;
+  using Mode = Oversampling::OSMode;
+
+  std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
+  Oversampling::createParameterLayout(
+      params, {Factor::OneX, Factor::TwoX, Factor::FourX, Factor::EightX},
+      {Mode::MinPhase, Mode::LinPhase}, Factor::FourX, Mode::MinPhase);
+
+  layout.add(params.begin(), params.end());
+
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "driveADAA", "Drive Anti-aliasing",
+      juce::StringArray{"Off", "1st Order", "2nd Order"}, Off));
+}
+
+void DriveStage::prepare(double sampleRate, int maxBlockSize,
+                         int numChannels) {
+  oversampling.prepareToPlay(sampleRate, maxBlockSize, numChannels);
+  oversampling.updateOSFactor(); // Picks the render factor when offline
+  antialiasing = (Antialiasing)(int)antialiasingParam->load();
+
+  // Size the bypass delay for the slowest mode so switching never allocates
+  float maxLatencyMs = 0.0f;
+  for (int mode = 0; mode < numModes; ++mode)
+    for (int factor = 0; factor < numFactors; ++factor)
+      maxLatencyMs = juce::jmax(maxLatencyMs,
+                                oversampling.getLatencyMilliseconds(
+                                    oversampling.getOSIndex(factor, mode)));
+
+  bypassDelay.prepare({sampleRate, (juce::uint32)maxBlockSize,
+                       (juce::uint32)numChannels});
+  bypassDelay.setMaximumDelayInSamples(
+      juce::jmax(1, (int)std::ceil(maxLatencyMs * 0.001f * sampleRate)));
+
+  updateLatency();
+  reset();
+}
+
+void DriveStage::reset() {
+  oversampling.reset();
+  adaa.reset();
+  bypassDelay.reset();
+}
+
+void DriveStage::updateOversampling() {
+  const auto newAntialiasing = (Antialiasing)(int)antialiasingParam->load();
+  const bool antialiasingChanged = newAntialiasing != antialiasing;
+  antialiasing = newAntialiasing;
+
+  if (!oversampling.updateOSFactor() && !antialiasingChanged)
+    return;
+
+  // The newly selected oversampler still holds state from its last use
+  reset();
+  updateLatency();
+}
+
+void DriveStage::updateLatency() {
+  // ADAA delays by half a sample per order, at the oversampled rate
+  const auto adaaDelay =
+      0.5f * (float)antialiasing / (float)oversampling.getOSFactor();
+  const auto latency =
+      juce::roundToInt(oversampling.getLatencySamples() + adaaDelay);
+  bypassDelay.setDelay((float)latency);
+  latencySamples = latency;
+}
+
+void DriveStage::process(juce::dsp::AudioBlock<float> &block,
+                         float driveAmount, bool bypassed) {
+  if (bypassed || juce::exactlyEqual(driveAmount, 0.0f)) {
+    processBypassed(block);
+    return;
+  }
+
+  if (oversampling.getOSFactor() == 1) {
+    shape(block, driveAmount);
+    return;
+  }
+
+  auto osBlock = oversampling.processSamplesUp(block);
+  shape(osBlock, driveAmount);
+  oversampling.processSamplesDown(block);
+}
+
+void DriveStage::shape(juce::dsp::AudioBlock<float> &block,
+                       float driveAmount) {
+  const auto numSamples = (int)block.getNumSamples();
+  const auto numChannels =
+      juce::jmin((int)block.getNumChannels(), ADAAShaper::maxChannels);
+
+  std::array<float *, ADAAShaper::maxChannels> channels{};
+  for (int ch = 0; ch < numChannels; ++ch)
+    channels[(size_t)ch] = block.getChannelPointer((size_t)ch);
+
+  if (antialiasing != Off)
+    adaa.setDrive(driveAmount);
+
+  switch (antialiasing) {
+  case FirstOrder:
+    adaa.processFirstOrder(channels.data(), numChannels, numSamples);
+    break;
+  case SecondOrder:
+    adaa.processSecondOrder(channels.data(), numChannels, numSamples);
+    break;
+  case Off:
+    for (int ch = 0; ch < numChannels; ++ch)
+      shapeStateless(channels[(size_t)ch], numSamples, driveAmount);
+    break;
+  }
+}
+
+void DriveStage::processBypassed(juce::dsp::AudioBlock<float> &block) {
+  if (latencySamples.load(std::memory_order_relaxed) == 0)
+    return;
+
+  juce::dsp::ProcessContextReplacing<float> context(block);
+  bypassDelay.process(context);
+}
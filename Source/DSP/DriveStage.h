@@ -0,0 +1,79 @@
+#pragma once
+
+#include "ADAAShaper.h"
+#include <atomic>
+#include <chowdsp_dsp_utils/chowdsp_dsp_utils.h>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+// Stranger arctan-style waveshaper (see applyDistortion in the porting guide).
+// SampleType is float, double or an xsimd batch of either.
+template <typename SampleType>
+inline SampleType applyDistortion(SampleType sample, float amount) noexcept {
+  using NumericType = chowdsp::SampleTypeHelpers::NumericType<SampleType>;
+
+  if (juce::exactlyEqual(amount, 0.0f))
+    return sample;
+
+  const auto k = (NumericType)amount;
+  constexpr auto pi = juce::MathConstants<NumericType>::pi;
+  constexpr auto deg = pi / (NumericType)180;
+  return ((NumericType)3 + k) * sample * (NumericType)20 * deg /
+         (pi + k * xsimd::abs(sample));
+}
+
+//==============================================================================
+/**
+ * Oversampled distortion stage.
+ *
+ * Every factor (1x/2x/4x/8x) and filter type (IIR minimum phase or linear
+ * phase FIR) is built in prepare(), so the host-facing "os_*" parameters can
+ * switch modes at runtime without allocating. A separate factor can be used
+ * for offline renders. The stage keeps the active mode's latency when Cleanse
+ * bypasses it, so toggling the switch never shifts the signal in time.
+ *
+ * The curve can also run with first- or second-order ADAA, which keeps
+ * aliasing low enough to use a lower oversampling factor at high drive.
+ */
+class DriveStage {
+public:
+  enum Antialiasing { Off = 0, FirstOrder, SecondOrder };
+
+  explicit DriveStage(const juce::AudioProcessorValueTreeState &vts);
+
+  // Adds the oversampling factor/mode (realtime and render) and ADAA
+  // parameters
+  static void addParameters(
+      juce::AudioProcessorValueTreeState::ParameterLayout &layout);
+
+  void prepare(double sampleRate, int maxBlockSize, int numChannels);
+  void reset();
+
+  // Audio thread, once per host block: picks up oversampling/ADAA changes
+  void updateOversampling();
+
+  void process(juce::dsp::AudioBlock<float> &block, float driveAmount,
+               bool bypassed);
+
+  // Integer latency of the active oversampling mode (any thread)
+  int getLatencySamples() const { return latencySamples.load(); }
+
+private:
+  void processBypassed(juce::dsp::AudioBlock<float> &block);
+  void shape(juce::dsp::AudioBlock<float> &block, float driveAmount);
+  void updateLatency();
+
+  chowdsp::VariableOversampling<float> oversampling;
+
+  std::atomic<float> *antialiasingParam = nullptr;
+  Antialiasing antialiasing = Off;
+  ADAAShaper adaa;
+
+  // Matches the oversampler latency when the shaper is bypassed
+  juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None>
+      bypassDelay;
+
+  std::atomic<int> latencySamples{0};
+
+  JUCE_DECLARE_NON_COPYABLE(DriveStage)
+};
@@ -0,0 +1,177 @@
+#include "FeedbackDelay.h"
+
+void FeedbackDelay::prepare(double sampleRate, int numChannels) {
+  fs = sampleRate;
+  numLineChannels = numChannels;
+  maxDelaySamples = (float)std::ceil(sampleRate * (double)maxDelaySeconds);
+
+  // Lagrange interpolation reads a few samples past the delay time
+  lineLength = (int)maxDelaySamples + interpolationMargin;
+  line.emplace(lineLength);
+  line->prepare({sampleRate, 1, (juce::uint32)numChannels});
+
+  for (auto *smoother : {&send, &wet, &dry, &feedbackGain})
+    smoother->reset(sampleRate, smoothingSeconds);
+  fadeSamples = juce::jmax(1, juce::roundToInt(crossfadeSeconds * sampleRate));
+
+  reset();
+}
+
+void FeedbackDelay::reset() {
+  if (line.has_value())
+    line->reset();
+
+  send.setCurrentAndTargetValue(0.0f);
+  wet.setCurrentAndTargetValue(0.0f);
+  dry.setCurrentAndTargetValue(1.0f);
+  feedbackGain.setCurrentAndTargetValue(0.0f);
+
+  fading = false;
+  fadePosition = 0;
+  quietSamples = 0;
+  freshSamples = 0; // chowdsp's reset() leaves the samples in place
+  active = false;
+}
+
+bool FeedbackDelay::isSilent() const {
+  const auto longestTap = juce::jmax(delaySamples, nextDelaySamples);
+  return !active ||
+         quietSamples > (int)std::ceil(longestTap) + interpolationMargin;
+}
+
+double FeedbackDelay::getTailSeconds(float delaySeconds, float feedback) {
+  delaySeconds = juce::jlimit(0.0f, maxDelaySeconds, delaySeconds);
+  if (feedback <= 0.0f)
+    return delaySeconds;
+
+  // Each repeat is feedback times the last
+  const auto repeats = std::log(silenceThreshold) /
+                       std::log(juce::jmin(feedback, 0.99f));
+  return (double)delaySeconds * (1.0 + std::ceil(repeats));
+}
+
+void FeedbackDelay::updateTargets(bool enabled, float delaySeconds,
+                                  float feedback, float mix) {
+  const bool on = enabled && mix > 0.0f;
+
+  if (on && !active) {
+    // Waking from silence: start at the new time, and read whatever the
+    // line held from before as silence rather than clearing it here
+    freshSamples = 0;
+    delaySamples = juce::jlimit(1.0f, maxDelaySamples, delaySeconds * (float)fs);
+    fading = false;
+    quietSamples = 0;
+    active = true;
+  }
+
+  if (!active)
+    return;
+
+  send.setTargetValue(on ? 1.0f : 0.0f);
+  dry.setTargetValue(on ? 1.0f - mix * 0.5f : 1.0f); // Prevents clipping
+  feedbackGain.setTargetValue(feedback);
+
+  // Switched off, the tail keeps the last mix; a zero mix fades it out
+  if (on || mix <= 0.0f)
+    wet.setTargetValue(on ? mix : 0.0f);
+
+  const auto target =
+      juce::jlimit(1.0f, maxDelaySamples, delaySeconds * (float)fs);
+  if (!fading && !juce::exactlyEqual(target, delaySamples)) {
+    nextDelaySamples = target;
+    fadePosition = 0;
+    fading = true;
+  }
+}
+
+// Every channel follows the same gain ramps and crossfade; process()
+// advances the shared state once they are all done
+float FeedbackDelay::processChannel(float *data, int channel,
+                                    int numSamples) noexcept {
+  auto s = send, w = wet, d = dry, fb = feedbackGain;
+  auto position = fadePosition;
+  bool crossfading = fading;
+  const bool masking = freshSamples < lineLength;
+  float peakWritten = 0.0f;
+
+  if (!crossfading)
+    line->setDelay(delaySamples);
+
+  for (int i = 0; i < numSamples; ++i) {
+    float delayed;
+
+    if (crossfading) {
+      const auto fade = (float)position / (float)fadeSamples;
+      auto from = line->popSample(channel, delaySamples, false);
+      auto to = line->popSample(channel, nextDelaySamples, false);
+      line->incrementReadPointer(channel);
+
+      if (masking) {
+        from = isStale(i, delaySamples) ? 0.0f : from;
+        to = isStale(i, nextDelaySamples) ? 0.0f : to;
+      }
+      delayed = from + fade * (to - from);
+
+      if (++position == fadeSamples) {
+        crossfading = false;
+        line->setDelay(nextDelaySamples);
+      }
+    } else {
+      delayed = line->popSample(channel);
+      if (masking && isStale(i, delaySamples))
+        delayed = 0.0f;
+    }
+
+    const auto input = data[i] * s.getNextValue() + delayed * fb.getNextValue();
+    line->pushSample(channel, input);
+    peakWritten = juce::jmax(peakWritten, std::abs(input));
+
+    data[i] = data[i] * d.getNextValue() + delayed * w.getNextValue();
+  }
+
+  return peakWritten;
+}
+
+void FeedbackDelay::process(juce::dsp::AudioBlock<float> &block, bool enabled,
+                            float delaySeconds, float feedback, float mix) {
+  updateTargets(enabled, delaySeconds, feedback, mix);
+  if (!active)
+    return;
+
+  const auto numSamples = (int)block.getNumSamples();
+  const auto numChannels =
+      juce::jmin((int)block.getNumChannels(), numLineChannels);
+
+  float peakWritten = 0.0f;
+  for (int ch = 0; ch < numChannels; ++ch)
+    peakWritten = juce::jmax(
+        peakWritten,
+        processChannel(block.getChannelPointer((size_t)ch), ch, numSamples));
+
+  for (auto *smoother : {&send, &wet, &dry, &feedbackGain})
+    smoother->skip(numSamples);
+
+  freshSamples = juce::jmin(lineLength, freshSamples + numSamples);
+
+  if (fading) {
+    fadePosition += numSamples;
+    if (fadePosition >= fadeSamples) {
+      delaySamples = nextDelaySamples;
+      fading = false;
+    }
+  }
+
+  // Asleep once nothing audible can come out of the line: either the wet
+  // level has faded out, or a full delay time has passed with only silence
+  // written
+  quietSamples = peakWritten < silenceThreshold ? quietSamples + numSamples : 0;
+
+  const bool wetSilent =
+      !wet.isSmoothing() && juce::exactlyEqual(wet.getTargetValue(), 0.0f);
+
+  if (!send.isSmoothing() && juce::exactlyEqual(send.getTargetValue(), 0.0f) &&
+      !dry.isSmoothing() && (wetSilent || isSilent())) {
+    active = false;
+    wet.setCurrentAndTargetValue(0.0f);
+  }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chowdsp_dsp_utils/chowdsp_dsp_utils.h>
+#include <juce_dsp/juce_dsp.h>
+#include <optional>
+
+//==============================================================================
+/**
+ * Stereo feedback delay (see the Delay section of the porting guide).
+ *
+ * The line is a chowdsp::DelayLine with third-order Lagrange interpolation,
+ * so delay times are not rounded to whole samples. prepare() sizes it for
+ * the longest delay time at the current sample rate, so process() never
+ * allocates.
+ *
+ * A new delay time crossfades from the old read tap to the new one rather
+ * than jumping or sweeping the read head; changes that arrive mid-fade wait
+ * for it to finish. Mix, dry level and feedback are smoothed.
+ *
+ * Switching the delay off stops new input but lets the echoes already in
+ * the line ring out. Once the wet level is silent, or the tail has decayed
+ * below the silence threshold, process() returns without touching the
+ * block. Waking up again doesn't clear the line; anything read from before
+ * the wake-up is taken as silence until the line has been written through.
+ */
+class FeedbackDelay {
+public:
+  static constexpr float maxDelaySeconds = 2.0f;
+  static constexpr double crossfadeSeconds = 0.05;
+  static constexpr double smoothingSeconds = 0.02;
+
+  // Peak level below which the line counts as silent (-100 dB)
+  static constexpr float silenceThreshold = 1.0e-5f;
+
+  void prepare(double sampleRate, int numChannels);
+  void reset();
+
+  void process(juce::dsp::AudioBlock<float> &block, bool enabled,
+               float delaySeconds, float feedback, float mix);
+
+  // False once the stage has nothing left to add to the signal
+  bool isActive() const { return active; }
+
+  // True once nothing audible is left in the line, even while enabled
+  bool isSilent() const;
+
+  // How long an impulse keeps echoing above the silence threshold
+  static double getTailSeconds(float delaySeconds, float feedback);
+
+private:
+  using Line =
+      chowdsp::DelayLine<float, chowdsp::DelayLineInterpolationTypes::Lagrange3rd>;
+
+  void updateTargets(bool enabled, float delaySeconds, float feedback,
+                     float mix);
+  // Returns the peak level written into the line
+  float processChannel(float *data, int channel, int numSamples) noexcept;
+
+  // True when a tap at this delay, this many samples into the block, would
+  // read something written before the line woke up
+  bool isStale(int offset, float tap) const noexcept {
+    return (float)(freshSamples + offset) < tap + (float)interpolationMargin;
+  }
+
+  static constexpr int interpolationMargin = 4;
+
+  std::optional<Line> line;
+  double fs = 48000.0;
+  int numLineChannels = 0, lineLength = 0;
+  float maxDelaySamples = 1.0f;
+
+  juce::SmoothedValue<float> send, wet, dry, feedbackGain;
+
+  // The read tap, and the one being faded to
+  float delaySamples = 1.0f, nextDelaySamples = 1.0f;
+  int fadeSamples = 1, fadePosition = 0;
+  bool fading = false;
+
+  int quietSamples = 0; // Since anything audible was written
+  int freshSamples = 0; // Written since waking, up to lineLength
+  bool active = false;
+};
@@ -0,0 +1,64 @@
+#include "MeterFeed.h"
+
+MeterFeed::MeterFeed() : queue((size_t)queueSize) {}
+
+void MeterFeed::prepare(double sampleRate, int maxBlockSize) {
+  // Every block's scope points must fit in one frame
+  decimation = juce::jmax(
+      1, (int)std::ceil(sampleRate / scopeRate),
+      (maxBlockSize + maxScopePoints - 1) / maxScopePoints);
+  reset();
+}
+
+void MeterFeed::reset() {
+  pending = {};
+  scopePhase = 0;
+}
+
+void MeterFeed::setEnabled(bool shouldBeEnabled) {
+  enabled.store(shouldBeEnabled, std::memory_order_relaxed);
+}
+
+void MeterFeed::measure(Tap tap,
+                        const juce::dsp::AudioBlock<float> &block) noexcept {
+  const auto numChannels = (int)block.getNumChannels();
+  const auto numSamples = (int)block.getNumSamples();
+  if (numChannels == 0 || numSamples == 0)
+    return;
+
+  Level level;
+  float meanSquare = 0.0f;
+  for (int ch = 0; ch < numChannels; ++ch) {
+    const auto *x = block.getChannelPointer((size_t)ch);
+    level.peak = juce::jmax(
+        level.peak,
+        chowdsp::FloatVectorOperations::findAbsoluteMaximum(x, numSamples));
+    meanSquare +=
+        juce::square(chowdsp::FloatVectorOperations::computeRMS(x, numSamples));
+  }
+  level.rms = std::sqrt(meanSquare / (float)numChannels);
+
+  pending.levels[(size_t)tap] = level;
+}
+
+void MeterFeed::publish(const juce::dsp::AudioBlock<float> &output,
+                        float gain) noexcept {
+  const auto numChannels = (int)output.getNumChannels();
+  const auto numSamples = (int)output.getNumSamples();
+  const auto *left = output.getChannelPointer(0);
+  const auto *right = output.getChannelPointer(numChannels > 1 ? 1 : 0);
+
+  auto &n = pending.numScopePoints;
+  for (int i = scopePhase; i < numSamples && n < maxScopePoints;
+       i += decimation)
+    pending.scope[(size_t)n++] = 0.5f * (left[i] + right[i]);
+
+  // Samples into the next block before its first point
+  scopePhase = (scopePhase - numSamples) % decimation;
+  if (scopePhase < 0)
+    scopePhase += decimation;
+
+  pending.gain = gain;
+  queue.try_enqueue(pending); // Dropped if the reader fell behind
+  n = 0;
+}
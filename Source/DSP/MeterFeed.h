@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chowdsp_dsp_data_structures/chowdsp_dsp_data_structures.h>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+ * Carries meter readings and a scope trace from the audio thread to the UI.
+ *
+ * For every block the chain processes, the audio thread measures peak and
+ * RMS at three taps, records the level gain it applied and decimates the
+ * output to about scopeRate for the scope. The result goes into a wait-free
+ * single-producer, single-consumer queue (moodycamel::ReaderWriterQueue)
+ * allocated in prepare(). If the UI falls behind, frames are dropped; the
+ * audio thread never waits for it.
+ *
+ * Measuring only runs while something reads the feed (setEnabled()).
+ */
+class MeterFeed {
+public:
+  enum Tap { Input = 0, PostDrive, Output, numTaps };
+
+  static constexpr double scopeRate = 3000.0;
+  static constexpr int maxScopePoints = 512; // Per frame
+  static constexpr int queueSize = 32;       // Frames
+
+  struct Level {
+    float peak = 0.0f, rms = 0.0f;
+  };
+
+  struct Frame {
+    std::array<Level, numTaps> levels;
+    float gain = 0.0f; // Input gain times output gain, as smoothed
+    int numScopePoints = 0;
+    std::array<float, maxScopePoints> scope; // Output, mid of both channels
+  };
+
+  MeterFeed();
+
+  // Audio stopped
+  void prepare(double sampleRate, int maxBlockSize);
+  void reset();
+
+  // Any thread: whether the audio thread should measure and publish
+  void setEnabled(bool shouldBeEnabled);
+  bool isEnabled() const noexcept {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  // Audio thread: measures one tap of the block being processed
+  void measure(Tap tap, const juce::dsp::AudioBlock<float> &block) noexcept;
+
+  // Audio thread: adds the output block to the scope and queues the frame.
+  // Call once per block, after every tap is measured.
+  void publish(const juce::dsp::AudioBlock<float> &output,
+               float gain) noexcept;
+
+  // Reader thread: the oldest unread frame, if any
+  bool pop(Frame &frame) noexcept { return queue.try_dequeue(frame); }
+
+private:
+  moodycamel::ReaderWriterQueue<Frame> queue;
+
+  Frame pending;
+  int decimation = 1;
+  int scopePhase = 0; // Samples until the next scope point
+
+  std::atomic<bool> enabled{false};
+
+  JUCE_DECLARE_NON_COPYABLE(MeterFeed)
+};
@@ -0,0 +1,542 @@
+#include "PartitionedConvolution.h"
+
+namespace {
+// Smallest tail partition; the worker gets twice this long to finish each
+// block
+constexpr size_t minTailBlockSize = 1024;
+
+// How often the worker looks for queued blocks. Well inside the two tail
+// blocks it has for each, even at 1024 samples and 192 kHz.
+constexpr int workerPollMs = 1;
+
+// History slots beyond those a tail block reads, so a block the worker is
+// still finishing after the audio thread gave up on it keeps its inputs for
+// this many more tail blocks
+constexpr size_t spareHistorySlots = 4;
+
+size_t getTailBlockSize(size_t maxBlockSize) {
+  const auto hostBlock = (size_t)juce::nextPowerOfTwo((int)maxBlockSize);
+  return juce::jmax(minTailBlockSize, 2 * hostBlock);
+}
+
+// A tail block is queued once its input is complete and is needed two
+// blocks later, so the head covers three tail blocks
+size_t getHeadLength(size_t irLength, size_t maxBlockSize) {
+  return juce::jmin(irLength, 3 * getTailBlockSize(maxBlockSize));
+}
+
+void copyBuffer(juce::AudioBuffer<float> &dest,
+                const juce::AudioBuffer<float> &source) {
+  juce::FloatVectorOperations::copy(dest.getWritePointer(0),
+                                    source.getReadPointer(0),
+                                    source.getNumSamples());
+}
+
+// Everything but the IR; the engines must have the same layout
+void copyEngineState(chowdsp::ConvolutionEngine<> &dest,
+                     const chowdsp::ConvolutionEngine<> &source) {
+  jassert(dest.fftSize == source.fftSize &&
+          dest.numInputSegments == source.numInputSegments);
+
+  dest.currentSegment = source.currentSegment;
+  dest.inputDataPos = source.inputDataPos;
+
+  copyBuffer(dest.bufferInput, source.bufferInput);
+  copyBuffer(dest.bufferOutput, source.bufferOutput);
+  copyBuffer(dest.bufferTempOutput, source.bufferTempOutput);
+  copyBuffer(dest.bufferOverlap, source.bufferOverlap);
+
+  for (size_t i = 0; i < source.buffersInputSegments.size(); ++i)
+    copyBuffer(dest.buffersInputSegments[i], source.buffersInputSegments[i]);
+}
+} // namespace
+
+//==============================================================================
+// One thread for every engine in the process. Engines flag that they have
+// queued a block and the worker polls the flag, so queueing never takes a
+// lock or signals an event. It holds its own lock only while it looks for
+// a block, and no block runs under it.
+class PartitionedConvolution::TailWorker : private juce::Thread {
+public:
+  TailWorker() : juce::Thread("Convolution tail") {
+    startThread(juce::Thread::Priority::high);
+  }
+
+  ~TailWorker() override { stopThread(1000); }
+
+  void add(PartitionedConvolution *engine) {
+    const juce::ScopedLock sl(lock);
+    engines.add(engine);
+  }
+
+  // Blocks until the worker has finished with the engine
+  void remove(PartitionedConvolution *engine) {
+    {
+      const juce::ScopedLock sl(lock);
+      engines.removeFirstMatchingValue(engine);
+    }
+
+    while (busyEngine.load(std::memory_order_acquire) == engine)
+      blockFinished.wait(-1);
+  }
+
+  // Audio thread: a block has been queued
+  void wake() noexcept { blockQueued.store(true, std::memory_order_release); }
+
+private:
+  void run() override {
+    juce::ScopedNoDenormals noDenormals;
+
+    while (!threadShouldExit()) {
+      if (!blockQueued.exchange(false, std::memory_order_acquire)) {
+        wait(workerPollMs);
+        continue;
+      }
+
+      while (runQueuedTailBlock()) {
+      }
+    }
+  }
+
+  bool runQueuedTailBlock() {
+    PartitionedConvolution *engine = nullptr;
+    TailJob *job = nullptr;
+    {
+      const juce::ScopedLock sl(lock);
+      for (auto *e : engines) {
+        if ((job = e->claimTailBlock()) != nullptr) {
+          engine = e;
+          break;
+        }
+      }
+
+      if (engine == nullptr)
+        return false;
+      busyEngine.store(engine, std::memory_order_relaxed);
+    }
+
+    engine->runTailBlock(*job, *engine->tail->fftObject);
+
+    busyEngine.store(nullptr, std::memory_order_release);
+    blockFinished.signal();
+    return true;
+  }
+
+  juce::CriticalSection lock;
+  juce::Array<PartitionedConvolution *> engines;
+
+  std::atomic<bool> blockQueued{false};
+  std::atomic<PartitionedConvolution *> busyEngine{nullptr};
+  juce::WaitableEvent blockFinished;
+};
+
+//==============================================================================
+PartitionedConvolution::PartitionedConvolution(size_t irLength_,
+                                               size_t maxBlockSize,
+                                               const float *initialIR)
+    : irLength(irLength_), headLength(getHeadLength(irLength_, maxBlockSize)),
+      head(headLength, maxBlockSize, initialIR) {
+  if (irLength <= maxDirectLength) {
+    directTaps.resize(irLength, 0.0f);
+    if (initialIR != nullptr)
+      std::copy(initialIR, initialIR + irLength, directTaps.begin());
+    directHistory.resize(2 * irLength, 0.0f);
+  } else if (irLength > headLength) {
+    tailBlockSize = getTailBlockSize(maxBlockSize);
+    tail = std::make_unique<chowdsp::ConvolutionEngine<>>(
+        irLength - headLength, tailBlockSize,
+        initialIR != nullptr ? initialIR + headLength : nullptr);
+    audioFFT = std::make_unique<juce::dsp::FFT>(
+        chowdsp::Math::log2(tail->fftSize));
+
+    // A block reads the history from two blocks back; the slot of the
+    // oldest is where its own spectrum goes once it has played
+    const auto segmentSize = (int)tail->fftSize * 2;
+    jassert(tail->buffersInputSegments.size() == tail->numSegments);
+    for (size_t i = 0; i < spareHistorySlots; ++i)
+      tail->buffersInputSegments.emplace_back(1, segmentSize);
+
+    // The engine's own IR segments become the first copy
+    tailIRs[0] = std::move(tail->buffersImpulseSegments);
+    tailIRs[1] = tailIRs[0];
+
+    for (auto *buffer :
+         {&tailInput, &tailPreviousInput, &tailPlayback, &tailOverlap})
+      buffer->resize(tailBlockSize, 0.0f);
+    for (auto &job : jobs) {
+      job.input.resize(tailBlockSize, 0.0f);
+      job.previousInput.resize(tailBlockSize, 0.0f);
+      job.segment.resize((size_t)segmentSize, 0.0f);
+      job.previousSegment.resize((size_t)segmentSize, 0.0f);
+      job.result.resize((size_t)segmentSize, 0.0f);
+    }
+
+    worker->add(this);
+  }
+
+  reset();
+}
+
+PartitionedConvolution::~PartitionedConvolution() {
+  if (tail != nullptr)
+    worker->remove(this);
+}
+
+void PartitionedConvolution::reset() {
+  head.reset();
+  std::fill(directHistory.begin(), directHistory.end(), 0.0f);
+  directPos = 0;
+
+  if (tail == nullptr)
+    return;
+
+  dropTailBlocks();
+  tail->reset();
+  for (auto *buffer :
+       {&tailInput, &tailPreviousInput, &tailPlayback, &tailOverlap})
+    std::fill(buffer->begin(), buffer->end(), 0.0f);
+  tailPos = 0;
+  historyPos = 0;
+}
+
+void PartitionedConvolution::copyStateFrom(PartitionedConvolution &other) {
+  jassert(other.irLength == irLength &&
+          other.head.blockSize == head.blockSize);
+
+  copyEngineState(head, other.head);
+  std::copy(other.directHistory.begin(), other.directHistory.end(),
+            directHistory.begin());
+  directPos = other.directPos;
+
+  if (tail == nullptr)
+    return;
+
+  // Whatever this engine had pending is about to be replaced
+  dropTailBlocks();
+
+  for (size_t i = 0; i < tail->buffersInputSegments.size(); ++i)
+    copyBuffer(tail->buffersInputSegments[i],
+               other.tail->buffersInputSegments[i]);
+  historyPos = other.historyPos;
+
+  std::copy(other.tailInput.begin(), other.tailInput.end(), tailInput.begin());
+  std::copy(other.tailPreviousInput.begin(), other.tailPreviousInput.end(),
+            tailPreviousInput.begin());
+  std::copy(other.tailPlayback.begin(), other.tailPlayback.end(),
+            tailPlayback.begin());
+  std::copy(other.tailOverlap.begin(), other.tailOverlap.end(),
+            tailOverlap.begin());
+  tailPos = other.tailPos;
+
+  // The other engine's pending blocks are run again here, with this IR
+  for (size_t i = 0; i < pendingJobs.size(); ++i) {
+    const auto *otherJob = other.pendingJobs[i];
+    if (otherJob == nullptr)
+      continue;
+
+    auto &job = getIdleJob();
+    job.input = otherJob->input;
+    job.previousInput = otherJob->previousInput;
+    job.newest = otherJob->newest;
+    queueTailBlock(job);
+    pendingJobs[i] = &job;
+  }
+}
+
+size_t PartitionedConvolution::getLargestBlockSize() const noexcept {
+  return juce::jmax(head.blockSize, tailBlockSize);
+}
+
+void PartitionedConvolution::processSamples(const float *input, float *output,
+                                            size_t numSamples) {
+  if (isDirect()) {
+    processDirect(input, output, numSamples);
+    return;
+  }
+
+  if (tail == nullptr) {
+    head.processSamples(input, output, numSamples);
+    return;
+  }
+
+  size_t done = 0;
+  while (done < numSamples) {
+    const auto chunk = juce::jmin(numSamples - done, tailBlockSize - tailPos);
+
+    // Keep the input before the head overwrites it in place
+    juce::FloatVectorOperations::copy(tailInput.data() + tailPos, input + done,
+                                      (int)chunk);
+    head.processSamples(input + done, output + done, chunk);
+    juce::FloatVectorOperations::add(output + done,
+                                     tailPlayback.data() + tailPos, (int)chunk);
+
+    tailPos += chunk;
+    done += chunk;
+
+    if (tailPos == tailBlockSize) {
+      startTailBlock();
+      tailPos = 0;
+    }
+  }
+}
+
+void PartitionedConvolution::processDirect(const float *input, float *output,
+                                           size_t numSamples) {
+  const auto length = directTaps.size();
+
+  for (size_t i = 0; i < numSamples; ++i) {
+    directPos = (directPos == 0 ? length : directPos) - 1;
+    directHistory[directPos] = directHistory[directPos + length] = input[i];
+    output[i] = chowdsp::FloatVectorOperations::innerProduct(
+        directHistory.data() + directPos, directTaps.data(), (int)length);
+  }
+}
+
+void PartitionedConvolution::startTailBlock() {
+  // The block queued two blocks ago is due now. Until one has been queued
+  // after a reset, the history moves on over silence.
+  if (auto *job = finishTailBlock()) {
+    playTailBlock(*job);
+  } else {
+    std::fill(tailPlayback.begin(), tailPlayback.end(), 0.0f);
+    tail->buffersInputSegments[historyPos].clear();
+    historyPos = getOlderSlot(historyPos);
+  }
+  pendingJobs[0] = pendingJobs[1];
+
+  // Its spectrum goes into the slot after the previous block's, which is
+  // played into the history first
+  auto &job = getIdleJob();
+  std::swap(tailInput, job.input);
+  std::copy(tailPreviousInput.begin(), tailPreviousInput.end(),
+            job.previousInput.begin());
+  std::copy(job.input.begin(), job.input.end(), tailPreviousInput.begin());
+  job.newest = getOlderSlot(historyPos);
+  queueTailBlock(job);
+  pendingJobs[1] = &job;
+}
+
+void PartitionedConvolution::queueTailBlock(TailJob &job) {
+  job.ir = currentIR;
+  job.order.store(tailBlocksQueued++, std::memory_order_relaxed);
+  job.state.store(Queued, std::memory_order_release);
+  worker->wake();
+}
+
+void PartitionedConvolution::playTailBlock(TailJob &job) {
+  // The block's input spectrum joins the history
+  jassert(job.newest == historyPos);
+  juce::FloatVectorOperations::copy(
+      tail->buffersInputSegments[job.newest].getWritePointer(0),
+      job.segment.data(), (int)job.segment.size());
+  historyPos = getOlderSlot(historyPos);
+
+  const auto *result = job.result.data();
+  juce::FloatVectorOperations::add(tailPlayback.data(), result,
+                                   tailOverlap.data(), (int)tailBlockSize);
+  std::copy(result + tailBlockSize, result + 2 * tailBlockSize,
+            tailOverlap.begin());
+
+  job.state.store(Idle, std::memory_order_relaxed);
+}
+
+size_t PartitionedConvolution::getOlderSlot(size_t slot) const noexcept {
+  return (slot == 0 ? tail->buffersInputSegments.size() : slot) - 1;
+}
+
+PartitionedConvolution::TailJob &PartitionedConvolution::getIdleJob() {
+  // Besides the pending blocks, the worker holds at most one job of an
+  // engine, so one is always free
+  for (auto &job : jobs)
+    if (job.state.load(std::memory_order_acquire) == Idle)
+      return job;
+
+  jassertfalse;
+  return jobs.back();
+}
+
+PartitionedConvolution::TailJob *PartitionedConvolution::finishTailBlock() {
+  auto *job = pendingJobs[0];
+  if (job == nullptr)
+    return nullptr;
+
+  auto state = job->state.load(std::memory_order_acquire);
+  if (state == Queued && job->state.compare_exchange_strong(
+                             state, Running, std::memory_order_acquire)) {
+    // The worker hasn't got to it; run it here
+    runTailBlock(*job, *audioFFT);
+    return job;
+  }
+
+  if (state == Running && job->state.compare_exchange_strong(
+                              state, Abandoned, std::memory_order_acquire)) {
+    // The worker is late; run the block again in a spare job and leave this
+    // one to it
+    auto &spare = getIdleJob();
+    spare.input = job->input;
+    spare.previousInput = job->previousInput;
+    spare.newest = job->newest;
+    spare.ir = job->ir;
+    spare.state.store(Running, std::memory_order_relaxed);
+    runTailBlock(spare, *audioFFT);
+    return &spare;
+  }
+
+  return job;
+}
+
+void PartitionedConvolution::dropTailBlocks() {
+  for (auto *&job : pendingJobs) {
+    if (job == nullptr)
+      continue;
+
+    // A block the worker is running is left to it; anything else is free
+    auto state = job->state.load(std::memory_order_acquire);
+    while (!job->state.compare_exchange_weak(state,
+                                             state == Running ? Abandoned
+                                                              : Idle,
+                                             std::memory_order_acquire)) {
+    }
+    job = nullptr;
+  }
+}
+
+PartitionedConvolution::TailJob *PartitionedConvolution::claimTailBlock() {
+  // Oldest first, so a block due next isn't kept waiting by the one after
+  for (;;) {
+    TailJob *oldest = nullptr;
+    for (auto &job : jobs)
+      if (job.state.load(std::memory_order_acquire) == Queued &&
+          (oldest == nullptr ||
+           (int32_t)(job.order.load(std::memory_order_relaxed) -
+                     oldest->order.load(std::memory_order_relaxed)) < 0))
+        oldest = &job;
+
+    if (oldest == nullptr)
+      return nullptr;
+
+    int expected = Queued;
+    if (oldest->state.compare_exchange_strong(expected, Running,
+                                              std::memory_order_acq_rel))
+      return oldest;
+  }
+}
+
+void PartitionedConvolution::runTailBlock(TailJob &job,
+                                          const juce::dsp::FFT &fft) {
+  int expected = Running;
+  if (computeTailBlock(job, fft) &&
+      job.state.compare_exchange_strong(expected, Done,
+                                        std::memory_order_release))
+    return;
+
+  // Abandoned by the audio thread, which has run the block itself
+  job.state.store(Idle, std::memory_order_release);
+}
+
+bool PartitionedConvolution::computeTailBlock(TailJob &job,
+                                              const juce::dsp::FFT &fft) {
+  // The same steps as chowdsp::ConvolutionEngine for a whole block, with
+  // the spectra of the new input and the one before kept in the job until
+  // they are played
+  const auto fftSize = tail->fftSize;
+  const auto numSlots = tail->buffersInputSegments.size();
+  const auto &impulseSegments = tailIRs[(size_t)job.ir];
+
+  auto transform = [&](const std::vector<float> &input, float *segment) {
+    std::copy(input.begin(), input.end(), segment);
+    std::fill(segment + tailBlockSize, segment + fftSize, 0.0f);
+    fft.performRealOnlyForwardTransform(segment);
+    tail->prepareForConvolution(segment, fftSize);
+  };
+
+  auto *segment = job.segment.data();
+  auto *previousSegment = job.previousSegment.data();
+  transform(job.input, segment);
+  transform(job.previousInput, previousSegment);
+
+  auto *result = job.result.data();
+  std::fill(job.result.begin(), job.result.end(), 0.0f);
+
+  for (size_t i = 1; i < tail->numSegments; ++i) {
+    if (job.state.load(std::memory_order_relaxed) == Abandoned)
+      return false;
+
+    const auto *input =
+        i == 1 ? previousSegment
+               : tail->buffersInputSegments[(job.newest + i) % numSlots]
+                     .getReadPointer(0);
+    tail->convolutionProcessingAndAccumulate(
+        input, impulseSegments[i].getReadPointer(0), result);
+  }
+
+  tail->convolutionProcessingAndAccumulate(
+      segment, impulseSegments.front().getReadPointer(0), result);
+  tail->updateSymmetricFrequencyDomainData(result);
+  fft.performRealOnlyInverseTransform(result);
+  return true;
+}
+
+//==============================================================================
+PartitionedConvolution::IRTransfer::IRTransfer(
+    const PartitionedConvolution &engine)
+    : headLength(engine.headLength), head(engine.head),
+      directTaps(engine.directTaps.size(), 0.0f) {
+  if (engine.tail != nullptr)
+    tail = std::make_unique<chowdsp::IRTransfer>(*engine.tail);
+}
+
+void PartitionedConvolution::IRTransfer::setNewIR(const float *newIR) {
+  juce::SpinLock::ScopedLockType lock(mutex);
+
+  head.setNewIR(newIR);
+  std::copy(newIR, newIR + directTaps.size(), directTaps.begin());
+  if (tail != nullptr)
+    tail->setNewIR(newIR + headLength);
+}
+
+void PartitionedConvolution::IRTransfer::transferIR(
+    PartitionedConvolution &engine) const {
+  head.transferIR(engine.head);
+  std::copy(directTaps.begin(), directTaps.end(), engine.directTaps.begin());
+  if (tail == nullptr || engine.tail == nullptr)
+    return;
+
+  engine.setTailIR(tail->buffersImpulseSegments);
+}
+
+void PartitionedConvolution::setTailIR(
+    const std::vector<juce::AudioBuffer<float>> &segments) {
+  // Blocks the worker hasn't started are held back while the IR is copied
+  // and then read the new one. The block it's running keeps its copy, so
+  // the new IR goes into the other.
+  decltype(pendingJobs) held{};
+  auto target = 1 - currentIR;
+
+  for (size_t i = 0; i < pendingJobs.size(); ++i) {
+    auto *job = pendingJobs[i];
+    if (job == nullptr)
+      continue;
+
+    auto state = job->state.load(std::memory_order_acquire);
+    if (state == Queued && job->state.compare_exchange_strong(
+                               state, Running, std::memory_order_acquire))
+      held[i] = job;
+    else if (state == Running)
+      target = 1 - job->ir;
+  }
+
+  auto &dest = tailIRs[(size_t)target];
+  for (size_t i = 0; i < segments.size(); ++i)
+    copyBuffer(dest[i], segments[i]);
+  currentIR = target;
+
+  for (auto *job : held) {
+    if (job == nullptr)
+      continue;
+
+    job->ir = target;
+    job->state.store(Queued, std::memory_order_release);
+    worker->wake();
+  }
+}
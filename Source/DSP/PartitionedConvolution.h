@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chowdsp_dsp_utils/chowdsp_dsp_utils.h>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+ * Zero-latency non-uniform partitioned convolution for one channel.
+ *
+ * chowdsp::ConvolutionEngine uses one partition size for the whole IR. For
+ * long IRs at small host buffers that means many small partitions, or an
+ * FFT of the whole tail every few blocks. This splits the IR in two:
+ *
+ *  - The head, the first 3 * tailBlockSize taps, runs on the audio thread
+ *    in partitions sized to the host block, with no added latency.
+ *  - The tail runs in partitions of tailBlockSize on a process-wide worker
+ *    thread. Each tail block is handed to the worker as soon as its input
+ *    is complete and is due two tail blocks later, when the head runs out.
+ *    A block transforms its own input and the one before it, which hasn't
+ *    been played into the history yet, so blocks don't wait on each other.
+ *
+ * The audio thread never waits for the worker or takes its lock: it sets a
+ * flag the worker polls. A tail block reads only the input history and the
+ * IR and writes only to its own job, so when the worker misses a deadline
+ * the audio thread runs the block itself: in the queued job if the worker
+ * hasn't started it, otherwise in a spare job, and the worker's copy is
+ * thrown away. The worker drops an abandoned block at its next segment.
+ * Spare history slots keep that block's inputs intact meanwhile; an IR
+ * loaded in that window only spoils output nobody plays.
+ *
+ * The tail IR is kept twice. A new IR goes into the copy the running block
+ * isn't reading, and blocks the worker hasn't started move over to it, so
+ * loading an IR never runs a block on the audio thread.
+ *
+ * IRs no longer than the head have no tail and behave like a plain
+ * ConvolutionEngine. IRs of at most maxDirectLength taps skip the FFTs
+ * altogether and run as a direct-form FIR.
+ *
+ * The IR length is fixed at construction. New IRs of that length are
+ * loaded through IRTransfer, which mirrors chowdsp::IRTransfer.
+ */
+class PartitionedConvolution {
+public:
+  // Below this many taps a direct-form FIR is cheaper than the FFTs
+  static constexpr size_t maxDirectLength = 256;
+
+  PartitionedConvolution(size_t irLength, size_t maxBlockSize,
+                         const float *initialIR = nullptr);
+  ~PartitionedConvolution();
+
+  // Audio thread, or any thread while the audio thread is stopped
+  void reset();
+
+  // Zero latency; input and output may be the same buffer
+  void processSamples(const float *input, float *output, size_t numSamples);
+
+  // Audio thread: takes over another engine's input history, so an IR
+  // loaded here beforehand sounds at once. Both engines must have the same
+  // layout. Tail output already playing on the other engine keeps its IR.
+  void copyStateFrom(PartitionedConvolution &other);
+
+  // Longest partition, which bounds how long a reset engine needs before
+  // its output is steady
+  size_t getLargestBlockSize() const noexcept;
+
+  bool hasTail() const noexcept { return tail != nullptr; }
+  bool isDirect() const noexcept { return !directTaps.empty(); }
+
+  // Transforms an IR on any thread; the audio thread copies it into engines
+  // under a try-lock of mutex
+  struct IRTransfer {
+    explicit IRTransfer(const PartitionedConvolution &engine);
+
+    // Loads a new IR of the engine's length
+    void setNewIR(const float *newIR);
+
+    // Audio thread, with mutex held
+    void transferIR(PartitionedConvolution &engine) const;
+
+    juce::SpinLock mutex;
+
+  private:
+    const size_t headLength;
+    chowdsp::IRTransfer head;
+    std::unique_ptr<chowdsp::IRTransfer> tail;
+    std::vector<float> directTaps;
+  };
+
+private:
+  class TailWorker;
+
+  enum JobState { Idle, Queued, Running, Abandoned, Done };
+
+  // One tail block. segment and previousSegment hold the spectra of its
+  // input and the block before; result holds the block's output followed by
+  // its overlap into the next block.
+  struct TailJob {
+    std::vector<float> input, previousInput, segment, previousSegment, result;
+    size_t newest = 0; // History slot the input's spectrum goes into
+    int ir = 0;        // Copy of the tail IR it reads
+    std::atomic<uint32_t> order{0}; // Queued blocks run oldest first
+    std::atomic<int> state{Idle};
+  };
+
+  // Audio thread
+  void startTailBlock();
+  void queueTailBlock(TailJob &job);
+  void setTailIR(const std::vector<juce::AudioBuffer<float>> &segments);
+  void playTailBlock(TailJob &job);
+  TailJob &getIdleJob();
+
+  // The history runs newest first, so the next spectrum goes in the slot
+  // before
+  size_t getOlderSlot(size_t slot) const noexcept;
+
+  // Makes sure the block due now has its result, running it here if the
+  // worker hasn't finished it. Returns the job holding the result.
+  TailJob *finishTailBlock();
+
+  // Drops the pending blocks; the worker lets go of them in its own time
+  void dropTailBlocks();
+
+  // Worker thread, under its lock: the oldest queued block, marked as
+  // running
+  TailJob *claimTailBlock();
+
+  // Either thread, once the block is marked as running. Each thread passes
+  // its own FFT, as some FFT engines keep scratch space.
+  void runTailBlock(TailJob &job, const juce::dsp::FFT &fft);
+  bool computeTailBlock(TailJob &job, const juce::dsp::FFT &fft);
+
+  void processDirect(const float *input, float *output, size_t numSamples);
+
+  const size_t irLength, headLength;
+  chowdsp::ConvolutionEngine<> head;
+
+  // The tail's layout and FFT. Its input segments are the history of
+  // input spectra, newest first from historyPos; only the audio thread
+  // writes them. Its IR segments live in tailIRs.
+  std::unique_ptr<chowdsp::ConvolutionEngine<>> tail;
+  std::unique_ptr<juce::dsp::FFT> audioFFT;
+  size_t tailBlockSize = 0, historyPos = 0;
+
+  // Two copies of the tail IR's segments; new blocks read currentIR
+  std::array<std::vector<juce::AudioBuffer<float>>, 2> tailIRs;
+  int currentIR = 0;
+
+  // Audio thread: input being collected, the last complete input block,
+  // the tail output being played and the overlap the last block left for
+  // the next
+  std::vector<float> tailInput, tailPreviousInput, tailPlayback, tailOverlap;
+  size_t tailPos = 0;
+  uint32_t tailBlocksQueued = 0;
+
+  // Two blocks pending, the one due next first, and a spare for a block the
+  // worker was late with
+  std::array<TailJob, 3> jobs;
+  std::array<TailJob *, 2> pendingJobs{};
+
+  // Direct-form FIR. The history is stored twice, so the latest irLength
+  // inputs are always contiguous, newest first.
+  std::vector<float> directTaps, directHistory;
+  size_t directPos = 0;
+
+  juce::SharedResourcePointer<TailWorker> worker;
+
+  JUCE_DECLARE_NON_COPYABLE(PartitionedConvolution)
+};
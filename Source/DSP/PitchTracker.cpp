@@ -0,0 +1,210 @@
+#include "PitchTracker.h"
+
+void PitchTracker::prepare(double sampleRate) {
+  decimation = juce::jmax(1, juce::roundToInt(sampleRate / analysisRate));
+  fsAnalysis = sampleRate / decimation;
+
+  // A quarter of the analysis rate rather than nearer Nyquist: the top
+  // notes are only five or six lags long, and their aliased upper
+  // harmonics would hide the dip at the fundamental
+  antiAliasing.prepare(1);
+  antiAliasing.calcCoefs(
+      (float)(0.25 * fsAnalysis),
+      chowdsp::CoefficientCalculators::butterworthQ<float>, (float)sampleRate);
+
+  minLag = juce::jmax(2, (int)(fsAnalysis / maxFrequencyHz));
+  maxLag = (int)std::ceil(fsAnalysis / minFrequencyHz);
+  frameSize = juce::nextPowerOfTwo(2 * maxLag);
+  window = frameSize - maxLag;
+
+  fft = std::make_unique<juce::dsp::FFT>(juce::roundToInt(std::log2(frameSize)));
+
+  history.assign((size_t)frameSize, 0.0f);
+  frame.assign((size_t)frameSize, 0.0f);
+  packed.assign((size_t)frameSize, {});
+  spectrum.assign((size_t)frameSize, {});
+  correlation.assign(2 * (size_t)frameSize, 0.0f);
+  difference.assign((size_t)maxLag + 1, 0.0f);
+
+  reset();
+}
+
+void PitchTracker::reset() {
+  antiAliasing.reset();
+  std::fill(history.begin(), history.end(), 0.0f);
+  decimationOffset = decimation - 1;
+  writePos = 0;
+  samplesSinceHop = 0;
+  stage = Stage::Idle;
+  periodSamples = 0.0f;
+  hopSize = frameSize / 4;
+}
+
+void PitchTracker::pushBlock(const float *left, const float *right,
+                             int numSamples) noexcept {
+  // Mono mix and filter a chunk at a time, then keep every decimation-th
+  // sample
+  std::array<float, chunkSize> mono;
+
+  for (int start = 0; start < numSamples; start += chunkSize) {
+    const auto n = juce::jmin(chunkSize, numSamples - start);
+
+    if (right != nullptr) {
+      juce::FloatVectorOperations::add(mono.data(), left + start,
+                                       right + start, n);
+      juce::FloatVectorOperations::multiply(mono.data(), 0.5f, n);
+    } else {
+      juce::FloatVectorOperations::copy(mono.data(), left + start, n);
+    }
+
+    antiAliasing.processBlock(mono.data(), n);
+
+    for (; decimationOffset < n; decimationOffset += decimation) {
+      history[(size_t)writePos] = mono[(size_t)decimationOffset];
+      if (++writePos == frameSize)
+        writePos = 0;
+      ++samplesSinceHop;
+    }
+    decimationOffset -= n;
+  }
+}
+
+bool PitchTracker::process(const juce::dsp::AudioBlock<float> &block) {
+  pushBlock(block.getChannelPointer(0),
+            block.getNumChannels() > 1 ? block.getChannelPointer(1) : nullptr,
+            (int)block.getNumSamples());
+
+  // At most one stage per block keeps the worst case to a single
+  // frameSize-point FFT
+  switch (stage) {
+  case Stage::Idle:
+    if (samplesSinceHop < hopSize)
+      return false;
+
+    samplesSinceHop = 0;
+
+    // Unroll the ring, oldest sample first
+    std::copy(history.begin() + writePos, history.end(), frame.begin());
+    std::copy(history.begin(), history.begin() + writePos,
+              frame.begin() + (frameSize - writePos));
+
+    if (juce::FloatVectorOperations::findMaximum(frame.data(), frameSize) <
+            silenceThreshold &&
+        -juce::FloatVectorOperations::findMinimum(frame.data(), frameSize) <
+            silenceThreshold) {
+      periodSamples = 0.0f;
+      hopSize = frameSize / 4;
+      return true;
+    }
+
+    stage = Stage::Transform;
+    return false;
+
+  case Stage::Transform:
+    transformFrame();
+    stage = Stage::Correlate;
+    return false;
+
+  case Stage::Correlate:
+    correlateFrame();
+    stage = Stage::Search;
+    return false;
+
+  case Stage::Search: {
+    const auto previous = periodSamples;
+    searchFrame();
+
+    // While a note holds its pitch, analyse half as often. A new note
+    // shows up as a jump at the next analysis and goes back to the short
+    // hop.
+    const auto steady =
+        previous > 0.0f &&
+        std::abs(periodSamples - previous) < previous * steadyTolerance;
+    hopSize = steady ? frameSize / 2 : frameSize / 4;
+    stage = Stage::Idle;
+    return true;
+  }
+  }
+
+  return false;
+}
+
+void PitchTracker::transformFrame() noexcept {
+  // Both transforms are of real signals, so they share one complex FFT:
+  // the window in the real part, the whole frame in the imaginary part
+  for (int j = 0; j < frameSize; ++j)
+    packed[(size_t)j] = {j < window ? frame[(size_t)j] : 0.0f,
+                         frame[(size_t)j]};
+
+  fft->perform(packed.data(), spectrum.data(), false);
+}
+
+void PitchTracker::correlateFrame() noexcept {
+  // Split the packed spectrum into W (window) and F (frame), then
+  // conj(W) * F gives the cross-correlation of the window against every
+  // lag of the frame. frameSize >= window + maxLag, so no lag wraps around.
+  for (int k = 0; k <= frameSize / 2; ++k) {
+    const auto z = spectrum[(size_t)k];
+    const auto zMirror =
+        std::conj(spectrum[(size_t)((frameSize - k) % frameSize)]);
+
+    const auto w = 0.5f * (z + zMirror);
+    const auto f = std::complex<float>(0.0f, -0.5f) * (z - zMirror);
+    const auto c = std::conj(w) * f;
+
+    correlation[2 * (size_t)k] = c.real();
+    correlation[2 * (size_t)k + 1] = c.imag();
+  }
+
+  fft->performRealOnlyInverseTransform(correlation.data());
+}
+
+void PitchTracker::searchFrame() noexcept {
+  // d(tau) = sum over the window of (x[j] - x[j + tau])^2
+  //        = energy(0) + energy(tau) - 2 * correlation(tau)
+  double energy0 = 0.0;
+  for (int j = 0; j < window; ++j)
+    energy0 += (double)frame[(size_t)j] * frame[(size_t)j];
+
+  auto energyTau = energy0;
+  difference[0] = 1.0f;
+
+  // Cumulative mean normalised difference (YIN step 3)
+  double runningSum = 0.0;
+  for (int tau = 1; tau <= maxLag; ++tau) {
+    const auto leaving = (double)frame[(size_t)tau - 1];
+    const auto entering = (double)frame[(size_t)(tau + window - 1)];
+    energyTau += entering * entering - leaving * leaving;
+
+    const auto d = juce::jmax(
+        0.0, energy0 + energyTau - 2.0 * (double)correlation[(size_t)tau]);
+    runningSum += d;
+    difference[(size_t)tau] =
+        runningSum > 0.0 ? (float)(d * tau / runningSum) : 1.0f;
+  }
+
+  // First dip below the threshold, followed down to its minimum
+  int tau = minLag;
+  while (tau < maxLag && difference[(size_t)tau] >= yinThreshold)
+    ++tau;
+
+  if (tau >= maxLag) {
+    periodSamples = 0.0f;
+    return;
+  }
+
+  while (tau + 1 < maxLag &&
+         difference[(size_t)tau + 1] < difference[(size_t)tau])
+    ++tau;
+
+  // Parabolic interpolation around the minimum
+  const auto prev = difference[(size_t)tau - 1];
+  const auto mid = difference[(size_t)tau];
+  const auto next = difference[(size_t)tau + 1];
+  const auto curvature = prev - 2.0f * mid + next;
+  const auto offset =
+      curvature > 0.0f ? juce::jlimit(-0.5f, 0.5f, 0.5f * (prev - next) / curvature)
+                       : 0.0f;
+
+  periodSamples = ((float)tau + offset) * (float)decimation;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <chowdsp_filters/chowdsp_filters.h>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+ * Low-frequency pitch tracker for Thicken, good down to the low strings of
+ * 8- and 9-string guitars at any sample rate.
+ *
+ * Works like chowdsp::TunerProcessor (autocorrelation over a window long
+ * enough for the lowest note, with a silence gate). The differences:
+ *
+ *  - It runs on a mono copy of the input, low-passed and decimated to about
+ *    6 kHz, so the window stays the same size at 96 or 192 kHz. At that
+ *    rate the lowest note fits a 512-point frame.
+ *  - It uses the YIN difference function, computed from an FFT
+ *    cross-correlation. YIN picks the fundamental more reliably than the
+ *    first autocorrelation peak when the low harmonics are strong.
+ *  - The window and frame transforms share one complex FFT, and the
+ *    analysis is split into stages, one per block, so a block never does
+ *    more than one FFT of analysis work.
+ *  - Once a note holds its pitch, it analyses half as often.
+ */
+class PitchTracker {
+public:
+  static constexpr double analysisRate = 6000.0;
+
+  // Tracked range. The top matches Thicken's old 40-sample minimum period
+  // at 48 kHz; the bottom is below the low C# of a 9-string.
+  static constexpr double minFrequencyHz = 25.0;
+  static constexpr double maxFrequencyHz = 1200.0;
+
+  // YIN aperiodicity threshold, and the level below which input is silence
+  static constexpr float yinThreshold = 0.15f;
+  static constexpr float silenceThreshold = 1.0e-2f;
+
+  // Two estimates in a row closer than this count as a held note
+  static constexpr float steadyTolerance = 0.05f;
+
+  void prepare(double sampleRate);
+  void reset();
+
+  // Feeds a block and advances the analysis by one stage. Returns true when
+  // a new estimate is available.
+  bool process(const juce::dsp::AudioBlock<float> &block);
+
+  // Latest period in input samples, or 0 if the input was silent or had no
+  // clear pitch
+  float getPeriodSamples() const noexcept { return periodSamples; }
+
+private:
+  enum class Stage { Idle, Transform, Correlate, Search };
+
+  void pushBlock(const float *left, const float *right,
+                 int numSamples) noexcept;
+  void transformFrame() noexcept;
+  void correlateFrame() noexcept;
+  void searchFrame() noexcept;
+
+  static constexpr int chunkSize = 256;
+
+  chowdsp::ButterworthFilter<4> antiAliasing;
+  int decimation = 1;
+  int decimationOffset = 0; // Next sample to keep, within the chunk
+  double fsAnalysis = analysisRate;
+
+  // frameSize = window + maxLag, so one FFT of that size holds every lag.
+  // hopSize is a quarter frame, or half a frame while the pitch is steady.
+  int window = 0, maxLag = 0, minLag = 0, frameSize = 0, hopSize = 0;
+  std::unique_ptr<juce::dsp::FFT> fft;
+
+  std::vector<float> history; // Ring of the last frameSize analysis samples
+  int writePos = 0, samplesSinceHop = 0;
+
+  std::vector<float> frame, correlation, difference;
+  std::vector<std::complex<float>> packed, spectrum;
+  Stage stage = Stage::Idle;
+
+  float periodSamples = 0.0f;
+};
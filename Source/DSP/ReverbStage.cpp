@@ -0,0 +1,203 @@
+#include "ReverbStage.h"
+
+namespace {
+struct Voicing {
+  float decay;         // Exponential decay rate of the web engine's IR
+  float sizeMs;        // Longest feedback delay
+  float diffusionMs;   // Longest diffuser delay before the chain spread
+  float highDecay;     // High-frequency T60 relative to the low one
+  float dampingHz;     // Where the high-frequency decay takes over
+};
+
+constexpr Voicing voicings[ReverbStage::numTypes] = {
+    {1.5f, 110.0f, 40.0f, 0.5f, 3000.0f}, // hall
+    {3.0f, 40.0f, 15.0f, 0.4f, 4000.0f},  // room
+    {2.5f, 65.0f, 8.0f, 0.8f, 6000.0f},   // plate
+    {4.0f, 30.0f, 4.0f, 0.5f, 2500.0f},   // spring
+    {1.0f, 140.0f, 50.0f, 0.6f, 3500.0f}, // ambient
+    {0.8f, 150.0f, 45.0f, 0.9f, 8000.0f}, // shimmer
+};
+
+// Each side feeds, and is read from, half of the lines
+constexpr float inputScale = 0.5f;
+
+// Wet level of the web engine's IR after JUCE's normalisation
+constexpr float targetWetLevel = 0.125f;
+
+// The web engine's IR decays as exp(-t * rate): T60 = ln(1000) / rate
+float getT60Ms(const Voicing &v, float decayKnob) {
+  const auto rate = v.decay * (1.0f - (decayKnob - 5.0f) * 0.1f);
+  return 1000.0f * std::log(1000.0f) / juce::jmax(rate, 0.01f);
+}
+
+// Spreads the lines by the golden ratio within their slots
+double goldenOffset(int index) {
+  const auto x = 0.5 + 0.6180339887 * (double)index;
+  return x - std::floor(x);
+}
+} // namespace
+
+//==============================================================================
+double ReverbStage::FDNConfig::getDelayMult(int channelIndex) {
+  return ((double)channelIndex + 1.0 + goldenOffset(channelIndex)) /
+         (double)(numLines + 1);
+}
+
+double ReverbStage::DiffuserConfig::getDelayMult(int channelIndex,
+                                                 int nChannels,
+                                                 std::mt19937 &) {
+  return ((double)channelIndex + 1.0 + goldenOffset(channelIndex + 3)) /
+         (double)(nChannels + 1);
+}
+
+double ReverbStage::DiffuserConfig::getPolarityMultiplier(int channelIndex,
+                                                          int,
+                                                          std::mt19937 &) {
+  return goldenOffset(channelIndex + 7) < 0.5 ? 1.0 : -1.0;
+}
+
+void ReverbStage::DiffuserConfig::fillChannelSwapIndexes(size_t *indexes,
+                                                         int numChannels,
+                                                         std::mt19937 &) {
+  // Odd stride, so every line is visited once
+  for (int i = 0; i < numChannels; ++i)
+    indexes[i] = (size_t)((i * 3 + 1) % numChannels);
+}
+
+//==============================================================================
+const juce::StringArray &ReverbStage::getTypeNames() {
+  static const juce::StringArray names{"hall",   "room",    "plate",
+                                       "spring", "ambient", "shimmer"};
+  return names;
+}
+
+void ReverbStage::prepare(double sampleRate, int, int) {
+  fs = sampleRate;
+
+  diffusers.prepare<chowdsp::Reverb::DiffuserChainHalfConfig, DiffuserConfig>(
+      sampleRate);
+  fdn.prepare(sampleRate);
+
+  typeFade.reset(sampleRate, typeFadeSeconds);
+  typeFade.setCurrentAndTargetValue(1.0f);
+
+  applySettings();
+  reset();
+}
+
+void ReverbStage::reset() {
+  diffusers.reset();
+  fdn.reset();
+
+  quietSamples = 0;
+  active = false;
+}
+
+double ReverbStage::getTailSeconds(int tailType, float tailDecayKnob) {
+  const auto &v = voicings[juce::jlimit(0, numTypes - 1, tailType)];
+
+  // The low band decays slowest; add the longest path through the
+  // diffusers and the network before the decay starts
+  const auto silenceDb = -20.0f * std::log10(silenceThreshold);
+  const auto decayMs = getT60Ms(v, tailDecayKnob) * silenceDb / 60.0f;
+  return (decayMs + (float)numDiffusers * v.diffusionMs + v.sizeMs) / 1000.0f;
+}
+
+void ReverbStage::setType(int newType, float newDecayKnob) {
+  newType = juce::jlimit(0, numTypes - 1, newType);
+  if (newType == type && juce::exactlyEqual(newDecayKnob, decayKnob))
+    return;
+
+  type = newType;
+  decayKnob = newDecayKnob;
+
+  // A new decay only changes the loop gains; a new type moves the delay
+  // taps, so that waits until the wet signal has faded out
+  if (type == appliedType)
+    applySettings();
+  else
+    typeFade.setTargetValue(0.0f);
+}
+
+void ReverbStage::applySettings() {
+  if (fs <= 0.0)
+    return;
+
+  const auto &v = voicings[type];
+  diffusers.setDiffusionTimeMs(v.diffusionMs);
+  fdn.setDelayTimeMs(v.sizeMs);
+
+  const auto t60Ms = getT60Ms(v, decayKnob);
+  fdn.getFDNConfig().setDecayTimeMs(fdn, t60Ms, t60Ms * v.highDecay,
+                                    v.dampingHz);
+
+  // A lossless network would ring forever; with loop gain g the energy
+  // an impulse leaves behind is 1 / (1 - g^2) of what went in
+  float meanDelayMs = 0.0f;
+  for (size_t i = 0; i < (size_t)numLines; ++i)
+    meanDelayMs += fdn.getChannelDelayMs(i) / (float)numLines;
+  const auto g = FDNConfig::calcGainForT60(t60Ms, meanDelayMs);
+  outputScale = targetWetLevel * std::sqrt(2.0f * (1.0f - g * g));
+  tailSamples = (int)std::ceil(getTailSeconds(type, decayKnob) * fs);
+
+  appliedType = type;
+}
+
+void ReverbStage::process(juce::dsp::AudioBlock<float> &block, float mix) {
+  if (appliedType != type && !typeFade.isSmoothing()) {
+    applySettings();
+    typeFade.setTargetValue(1.0f);
+  }
+
+  const auto numSamples = (int)block.getNumSamples();
+  const auto dryLevel = 1.0f - mix * 0.5f;
+
+  const auto range = block.findMinAndMax();
+  if (juce::jmax(-range.getStart(), range.getEnd()) >= silenceThreshold) {
+    quietSamples = 0;
+    active = true;
+  } else if (active) {
+    quietSamples += numSamples;
+    active = quietSamples <= tailSamples;
+  }
+
+  // The network holds nothing audible, so new settings can apply at once
+  if (!active) {
+    if (appliedType != type) {
+      applySettings();
+      typeFade.setCurrentAndTargetValue(1.0f);
+    }
+
+    block.multiplyBy(dryLevel);
+    return;
+  }
+
+  auto *left = block.getChannelPointer(0);
+  auto *right = block.getNumChannels() > 1 ? block.getChannelPointer(1)
+                                           : nullptr;
+
+  alignas(chowdsp::SIMDUtils::defaultSIMDAlignment)
+      std::array<float, numLines> lines;
+
+  for (int i = 0; i < numSamples; ++i) {
+    const auto inLeft = left[i] * inputScale;
+    const auto inRight = (right != nullptr ? right[i] : left[i]) * inputScale;
+    for (size_t n = 0; n < lines.size(); n += 2) {
+      lines[n] = inLeft;
+      lines[n + 1] = inRight;
+    }
+
+    const auto *out = fdn.process(diffusers.process(lines.data()));
+
+    float wetLeft = 0.0f, wetRight = 0.0f;
+    for (size_t n = 0; n < lines.size(); n += 2) {
+      wetLeft += out[n];
+      wetRight += out[n + 1];
+    }
+
+    const auto wet = typeFade.getNextValue() * outputScale * mix;
+    left[i] = left[i] * dryLevel + wetLeft * wet;
+    if (right != nullptr)
+      right[i] = right[i] * dryLevel + wetRight * wet;
+  }
+}
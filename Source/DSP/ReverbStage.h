@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chowdsp_reverb/chowdsp_reverb.h>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+ * Reverb: an algorithmic network voiced after createReverbImpulse and
+ * updateReverbType in the web engine.
+ *
+ * A chain of chowdsp::Reverb diffusers feeds an eight-line feedback delay
+ * network. Each type sets the network size, the diffusion time and the
+ * high-frequency damping. The web engine's decay rate gives the
+ * low-frequency T60, so the decay knob behaves as it did with the noise
+ * IR, and the output is scaled to the same level as the normalised IR.
+ *
+ * The cost per sample is the same for every type and decay time. The delay
+ * memory is static, so changing type or decay never allocates. A type
+ * change dips the wet signal for a few milliseconds while the delay taps
+ * move.
+ *
+ * Once the input has been silent for as long as the tail takes to fall
+ * below the silence threshold, process() only scales the dry signal.
+ */
+class ReverbStage {
+public:
+  enum Type { Hall = 0, Room, Plate, Spring, Ambient, Shimmer, numTypes };
+
+  // Choice names used by the reverbType parameter
+  static const juce::StringArray &getTypeNames();
+
+  static constexpr int numLines = 8;
+  static constexpr int numDiffusers = 4;
+  static constexpr double typeFadeSeconds = 0.01;
+
+  // Peak level below which the input and tail count as silent (-100 dB)
+  static constexpr float silenceThreshold = 1.0e-5f;
+
+  void prepare(double sampleRate, int maxBlockSize, int numChannels);
+  void reset();
+
+  // Cheap when nothing changed; call once per block
+  void setType(int type, float decayKnob);
+
+  void process(juce::dsp::AudioBlock<float> &block, float mix);
+
+  // False once the tail has died away and only silence is coming in
+  bool isActive() const { return active; }
+
+  // How long an impulse takes to fall below the silence threshold
+  static double getTailSeconds(int type, float decayKnob);
+
+private:
+  // chowdsp's configs are used statically, never deleted through a base
+  JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE("-Wnon-virtual-dtor")
+  struct FDNConfig final
+      : chowdsp::Reverb::DefaultFDNConfig<float, numLines> {
+    // Fixed rather than random delay spreads, so every instance and every
+    // session sounds the same
+    static double getDelayMult(int channelIndex);
+  };
+  JUCE_END_IGNORE_WARNINGS_GCC_LIKE
+
+  struct DiffuserConfig : chowdsp::Reverb::DefaultDiffuserConfig {
+    static double getDelayMult(int channelIndex, int nChannels,
+                               std::mt19937 &);
+    static double getPolarityMultiplier(int channelIndex, int nChannels,
+                                        std::mt19937 &);
+    static void fillChannelSwapIndexes(size_t *indexes, int numChannels,
+                                       std::mt19937 &);
+  };
+
+  // Sized for the longest voicing at 192 kHz
+  using NoInterp = chowdsp::DelayLineInterpolationTypes::None;
+  using Diffuser = chowdsp::Reverb::Diffuser<float, numLines, NoInterp, 1 << 14>;
+
+  void applySettings();
+
+  chowdsp::Reverb::DiffuserChain<numDiffusers, Diffuser> diffusers;
+  chowdsp::Reverb::FDN<FDNConfig, NoInterp, 1 << 15> fdn;
+
+  double fs = 0.0;
+  int type = Room, appliedType = -1;
+  float decayKnob = 5.0f;
+  float outputScale = 0.0f;
+
+  int tailSamples = 0;
+  int quietSamples = 0; // Since the input was last audible
+  bool active = false;
+
+  // Ducks the wet signal across type changes
+  juce::SmoothedValue<float> typeFade;
+};
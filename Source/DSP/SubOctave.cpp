@@ -0,0 +1,118 @@
+#include "SubOctave.h"
+
+void SubOctave::prepare(double sampleRate) {
+  tracker.prepare(sampleRate);
+  reset();
+}
+
+void SubOctave::reset() {
+  tracker.reset();
+  lock = {};
+
+  period = envelope = subGain = 0.0;
+  oscCos = rotCos = 1.0;
+  oscSin = rotSin = 0.0;
+}
+
+bool SubOctave::registerPeriod(float newPeriod, Lock &state) {
+  if (newPeriod <= 0.0f)
+    return false;
+
+  auto &hist = state.periodHistory;
+  bool lostLock = false;
+
+  // A jump of more than 15% means a new note: drop the lock and start over
+  if (state.period > 0.0f &&
+      std::abs(newPeriod - state.period) > state.period * stabilityThreshold) {
+    hist.fill(0.0f);
+    state.periodIndex = 0;
+    state.period = 0.0f;
+    lostLock = true;
+  }
+
+  hist[(size_t)state.periodIndex] = newPeriod;
+  state.periodIndex = (state.periodIndex + 1) % (int)hist.size();
+
+  if (hist[0] <= 0.0f || hist[1] <= 0.0f || hist[2] <= 0.0f ||
+      hist[3] <= 0.0f)
+    return lostLock;
+
+  const auto avg = (hist[0] + hist[1] + hist[2] + hist[3]) * 0.25f;
+  auto maxDev = 0.0f;
+  for (auto p : hist)
+    maxDev = juce::jmax(maxDev, std::abs(p - avg));
+
+  if (maxDev < avg * stabilityThreshold)
+    state.period = avg;
+
+  return lostLock;
+}
+
+void SubOctave::updatePeriod(float newPeriod) {
+  const auto oldPeriod = lock.period;
+
+  if (registerPeriod(newPeriod, lock)) {
+    subGain = 0.0;
+    oscCos = 1.0;
+    oscSin = 0.0;
+  }
+
+  if (juce::exactlyEqual(lock.period, oldPeriod))
+    return;
+
+  // Half the detected frequency: pi radians per period
+  const auto w = lock.period > 0.0f
+                     ? juce::MathConstants<double>::pi / (double)lock.period
+                     : 0.0;
+  period = (double)lock.period;
+  rotCos = std::cos(w);
+  rotSin = std::sin(w);
+}
+
+void SubOctave::process(juce::dsp::AudioBlock<float> &block, float amount) {
+  const auto numSamples = (int)block.getNumSamples();
+  auto *left = block.getChannelPointer(0);
+  auto *right = block.getNumChannels() > 1 ? block.getChannelPointer(1)
+                                           : nullptr;
+
+  if (tracker.process(block))
+    updatePeriod(tracker.getPeriodSamples());
+
+  const auto mix = StereoVec((double)(amount * mixScale));
+  const StereoVec zero(0.0), one(1.0);
+
+  auto env = envelope, gain = subGain;
+  auto c = oscCos, s = oscSin;
+
+  for (int i = 0; i < numSamples; ++i) {
+    const StereoVec x((double)left[i], right != nullptr ? (double)right[i]
+                                                        : 0.0);
+
+    env = env * (double)envelopeRelease + xsimd::abs(x) * (double)envelopeAttack;
+
+    const auto hasLock = (period > zero) & (env > StereoVec(0.01));
+
+    const auto nextC = c * rotCos - s * rotSin;
+    const auto nextS = s * rotCos + c * rotSin;
+    c = xsimd::select(hasLock, nextC, c);
+    s = xsimd::select(hasLock, nextS, s);
+
+    gain = xsimd::select(hasLock,
+                         xsimd::min(one, gain + (double)subGainAttack),
+                         xsimd::max(zero, gain - (double)subGainRelease));
+
+    const auto y = x + s * env * gain * mix;
+    left[i] = (float)y.get(0);
+    if (right != nullptr)
+      right[i] = (float)y.get(1);
+  }
+
+  // The rotation drifts off the unit circle very slowly; pull it back
+  const auto norm = c * c + s * s;
+  const auto correction = StereoVec(1.5) - 0.5 * norm;
+
+  envelope = xsimd::select(env < StereoVec(1.0e-8), zero, env);
+  subGain = gain;
+  oscCos = c * correction;
+  oscSin = s * correction;
+}
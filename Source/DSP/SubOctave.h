@@ -0,0 +1,69 @@
+#pragma once
+
+#include "PitchTracker.h"
+#include <array>
+#include <chowdsp_simd/chowdsp_simd.h>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+ * Thicken: pitch-tracking sub-octave generator.
+ * Port of amp-processor.js. The pitch comes from a PitchTracker rather
+ * than the script's zero-crossing counter, which could not follow the low
+ * strings at high sample rates. The lock logic is unchanged: a new period
+ * must agree with the last four within 15%, and a larger jump is treated
+ * as a new note.
+ *
+ * Both channels run in the lanes of one two-lane double batch, and the
+ * per-sample work (envelope, lock, gain ramp and oscillator) has no
+ * branches. The tracked period only changes between blocks.
+ *
+ * The sub-octave is a recursive quadrature oscillator: a phasor rotated by
+ * pi / period each sample, in place of sin() of an accumulated phase. The
+ * rotation is only recomputed when the tracked period changes.
+ */
+class SubOctave {
+public:
+  using StereoVec = xsimd::make_sized_batch_t<double, 2>;
+  static_assert(!std::is_void_v<StereoVec>,
+                "Target has no two-lane double SIMD type");
+
+  static constexpr int maxChannels = 2;
+
+  // Key constants from JUCE_PORTING_GUIDE.md. The period range is now
+  // PitchTracker's frequency range.
+  static constexpr float stabilityThreshold = 0.15f;
+  static constexpr float envelopeAttack = 0.005f;
+  static constexpr float envelopeRelease = 0.995f;
+  static constexpr float subGainAttack = 0.0003f;
+  static constexpr float subGainRelease = 0.01f;
+  static constexpr float mixScale = 2.5f;
+
+  SubOctave() { reset(); }
+
+  void prepare(double sampleRate);
+  void reset();
+
+  // amount is the normalised 0 - 1 Thicken knob
+  void process(juce::dsp::AudioBlock<float> &block, float amount);
+
+private:
+  struct Lock {
+    std::array<float, 4> periodHistory{};
+    int periodIndex = 0;
+    float period = 0.0f;
+  };
+
+  // Returns true if the period jumped and the lock was dropped
+  static bool registerPeriod(float period, Lock &state);
+
+  void updatePeriod(float newPeriod);
+
+  PitchTracker tracker;
+  Lock lock;
+
+  // One lane per channel
+  StereoVec period, envelope, subGain;
+  StereoVec oscCos, oscSin; // Phasor at half the tracked frequency
+  StereoVec rotCos, rotSin; // Its rotation per sample
+};
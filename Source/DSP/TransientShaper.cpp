@@ -0,0 +1,162 @@
+#include "TransientShaper.h"
+
+//==============================================================================
+void TransientShaper::Crossover::prepare(double sampleRate, float frequency) {
+  const juce::dsp::ProcessSpec spec{sampleRate, 1, 1};
+  split.prepare(spec);
+  lowpass.prepare(spec);
+  highpass.prepare(spec);
+
+  // Two cascaded Butterworth sections per band
+  const StereoVec q(juce::MathConstants<double>::sqrt2 * 0.5);
+  split.setQValue(q);
+  lowpass.setQValue(q);
+  highpass.setQValue(q);
+
+  split.setCutoffFrequency(StereoVec((double)frequency));
+  lowpass.setCutoffFrequency(StereoVec((double)frequency));
+  highpass.setCutoffFrequency(StereoVec((double)frequency));
+}
+
+void TransientShaper::Crossover::reset() {
+  split.reset();
+  lowpass.reset();
+  highpass.reset();
+}
+
+std::pair<TransientShaper::StereoVec, TransientShaper::StereoVec>
+TransientShaper::Crossover::process(StereoVec x) noexcept {
+  const auto [low, high] = split.processSample(0, x);
+
+  // The crossover section inverts its highpass output
+  return {lowpass.processSample(0, low), -highpass.processSample(0, high)};
+}
+
+//==============================================================================
+
+void TransientShaper::prepare(double sampleRate, int maxBlockSize,
+                              int numChannels) {
+  controlInterval = juce::jmax(1, juce::roundToInt(sampleRate / controlRate));
+  intervalRelease = std::pow(envelopeRelease, (float)controlInterval);
+
+  highSplit.prepare(sampleRate, highSplitHz);
+  lowSplit.prepare(sampleRate, lowSplitHz);
+  highAllpass.prepare(sampleRate, lowSplitHz);
+
+  bandBuffer.setSize(juce::jmin(numChannels, maxChannels), maxBlockSize);
+
+  reset();
+}
+
+void TransientShaper::reset() {
+  for (auto &s : state)
+    s = {};
+  samplesToUpdate = controlInterval;
+
+  for (auto *crossover : {&highSplit, &lowSplit, &highAllpass})
+    crossover->reset();
+  wasSplit = false;
+}
+
+void TransientShaper::updateGain(ChannelState &s, float amount) const noexcept {
+  s.envelope = s.envelope * intervalRelease + s.peak * (1.0f - intervalRelease);
+  const auto transient =
+      juce::jmax(0.0f, s.peak - s.envelope * transientThreshold);
+  const auto target = 1.0f + transient * amount * transientGain;
+
+  s.gainStep = (target - s.gain) / (float)controlInterval;
+  s.peak = 0.0f;
+  juce::dsp::util::snapToZero(s.envelope);
+}
+
+void TransientShaper::shape(float *const *channels, int numChannels,
+                            int numSamples, float amount) noexcept {
+  for (int start = 0; start < numSamples;) {
+    const auto length = juce::jmin(samplesToUpdate, numSamples - start);
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+      auto &s = state[(size_t)ch];
+      auto *data = channels[ch] + start;
+
+      const auto range =
+          juce::FloatVectorOperations::findMinAndMax(data, length);
+      s.peak = juce::jmax(s.peak, -range.getStart(), range.getEnd());
+
+      const auto gain = s.gain, step = s.gainStep;
+      for (int i = 0; i < length; ++i)
+        data[i] *= gain + step * (float)i;
+      s.gain = gain + step * (float)length;
+    }
+
+    start += length;
+    samplesToUpdate -= length;
+
+    if (samplesToUpdate == 0) {
+      for (int ch = 0; ch < numChannels; ++ch)
+        updateGain(state[(size_t)ch], amount);
+      samplesToUpdate = controlInterval;
+    }
+  }
+}
+
+// Leaves the sub band plus the phase-matched highs in the block, and the
+// 80 - 800 Hz band in bandBuffer
+void TransientShaper::splitIntoBands(
+    const juce::dsp::AudioBlock<float> &block) noexcept {
+  const auto numSamples = (int)block.getNumSamples();
+  auto *left = block.getChannelPointer(0);
+  auto *right = block.getNumChannels() > 1 ? block.getChannelPointer(1)
+                                           : nullptr;
+  auto *bandLeft = bandBuffer.getWritePointer(0);
+  auto *bandRight = right != nullptr ? bandBuffer.getWritePointer(1) : nullptr;
+
+  for (int i = 0; i < numSamples; ++i) {
+    const StereoVec x((double)left[i], right != nullptr ? (double)right[i]
+                                                        : 0.0);
+
+    const auto [low, high] = highSplit.process(x);
+    const auto [sub, band] = lowSplit.process(low);
+    const auto [highLow, highHigh] = highAllpass.process(high);
+    const auto rest = sub + highLow + highHigh;
+
+    left[i] = (float)rest.get(0);
+    bandLeft[i] = (float)band.get(0);
+    if (right != nullptr) {
+      right[i] = (float)rest.get(1);
+      bandRight[i] = (float)band.get(1);
+    }
+  }
+}
+
+void TransientShaper::process(juce::dsp::AudioBlock<float> &block,
+                              float amount, bool splitBands) {
+  const auto numSamples = (int)block.getNumSamples();
+  const auto numChannels = juce::jmin((int)block.getNumChannels(),
+                                      bandBuffer.getNumChannels());
+
+  if (!splitBands) {
+    wasSplit = false;
+
+    std::array<float *, maxChannels> channels{};
+    for (int ch = 0; ch < numChannels; ++ch)
+      channels[(size_t)ch] = block.getChannelPointer((size_t)ch);
+
+    shape(channels.data(), numChannels, numSamples, amount);
+    return;
+  }
+
+  if (!wasSplit) {
+    for (auto *crossover : {&highSplit, &lowSplit, &highAllpass})
+      crossover->reset();
+    wasSplit = true;
+  }
+
+  auto channelsBlock = block.getSubsetChannelBlock(0, (size_t)numChannels);
+  splitIntoBands(channelsBlock);
+  shape(bandBuffer.getArrayOfWritePointers(), numChannels, numSamples, amount);
+
+  for (int ch = 0; ch < numChannels; ++ch)
+    juce::FloatVectorOperations::add(block.getChannelPointer((size_t)ch),
+                                     bandBuffer.getReadPointer(ch),
+                                     numSamples);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <chowdsp_filters/chowdsp_filters.h>
+#include <chowdsp_simd/chowdsp_simd.h>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+ * Chug Enhancer: transient boost for palm-muted playing.
+ * Port of the envelope follower / transient detector in amp-processor.js.
+ *
+ * The detector runs at a control rate of about 3 kHz rather than per
+ * sample. Each control period takes the peak level of its samples (a
+ * vectorised min/max scan) and updates the envelope with the script's
+ * per-sample coefficient raised to the period length. The gain,
+ * 1 + transient * amount * 4, is then ramped linearly across the next
+ * period.
+ *
+ * With band splitting on, Linkwitz-Riley crossovers at 80 Hz and 800 Hz
+ * isolate the palm-mute band, and only that band is shaped. The band
+ * above 800 Hz goes through a matching 80 Hz allpass so the three bands
+ * still sum flat. The crossovers run both channels in one two-lane SIMD
+ * register, as BiquadCascade does.
+ */
+class TransientShaper {
+public:
+  using StereoVec = xsimd::make_sized_batch_t<double, 2>;
+  static_assert(!std::is_void_v<StereoVec>,
+                "Target has no two-lane double SIMD type");
+
+  static constexpr int maxChannels = 2;
+
+  static constexpr double controlRate = 3000.0;
+  static constexpr float lowSplitHz = 80.0f;
+  static constexpr float highSplitHz = 800.0f;
+
+  // Constants from amp-processor.js
+  static constexpr float envelopeRelease = 0.995f; // Per sample
+  static constexpr float transientThreshold = 1.5f;
+  static constexpr float transientGain = 4.0f;
+
+  void prepare(double sampleRate, int maxBlockSize, int numChannels);
+  void reset();
+
+  // amount is the normalised 0 - 1 Chug Enhance knob
+  void process(juce::dsp::AudioBlock<float> &block, float amount,
+               bool splitBands);
+
+private:
+  struct ChannelState {
+    float envelope = 0.0f;
+    float peak = 0.0f; // Of the control period so far
+    float gain = 1.0f, gainStep = 0.0f;
+  };
+
+  void shape(float *const *channels, int numChannels, int numSamples,
+             float amount) noexcept;
+  void splitIntoBands(const juce::dsp::AudioBlock<float> &block) noexcept;
+  void updateGain(ChannelState &s, float amount) const noexcept;
+
+  std::array<ChannelState, maxChannels> state;
+  int controlInterval = 1, samplesToUpdate = 1;
+  float intervalRelease = envelopeRelease;
+
+  // Fourth-order Linkwitz-Riley split with the topology of
+  // chowdsp::LinkwitzRileyFilter<T, 4>. Its processSample() drops the
+  // second-stage outputs and its processBlock() only takes scalar types.
+  struct Crossover {
+    void prepare(double sampleRate, float frequency);
+    void reset();
+    std::pair<StereoVec, StereoVec> process(StereoVec x) noexcept;
+
+    chowdsp::StateVariableFilter<
+        StereoVec, chowdsp::StateVariableFilterType::Crossover, 1>
+        split;
+    chowdsp::SVFLowpass<StereoVec, 1> lowpass;
+    chowdsp::SVFHighpass<StereoVec, 1> highpass;
+  };
+
+  Crossover highSplit, lowSplit, highAllpass;
+  juce::AudioBuffer<float> bandBuffer; // The palm-mute band
+  bool wasSplit = false;
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "DSP/ReverbStage.h"
+#include <array>
+#include <string_view>
+
+//==============================================================================
+/**
+ * Every parameter the processor declares, in one constexpr table (ranges
+ * and defaults from JUCE_PORTING_GUIDE.md). The processor builds the APVTS
+ * layout and its raw value pointers from it, indexed by ID, so nothing on
+ * the audio thread looks a parameter up by name.
+ *
+ * Entries are in host order; don't reorder them. Parameters owned by DSP
+ * stages (oversampling, ADAA, tone folding, chug band split) are added by
+ * AmpChain::addParameters().
+ */
+namespace ParameterTable {
+enum ID {
+  inputLevel = 0,
+  inputGain,
+  bass,
+  mid,
+  treble,
+  presence,
+  drive,
+  punish,
+  plus10db,
+  plusLow,
+  thicken,
+  thickenEnabled,
+  chugEnhance,
+  chugEnabled,
+  lofi,
+  cleanse,
+  masterVolume,
+  outputLevel,
+  peqEnabled,
+  peqBand1Freq,
+  peqBand1Gain,
+  peqBand1Q,
+  peqBand2Freq,
+  peqBand2Gain,
+  peqBand2Q,
+  peqBand3Freq,
+  peqBand3Gain,
+  peqBand3Q,
+  peqBand4Freq,
+  peqBand4Gain,
+  peqBand4Q,
+  delayEnabled,
+  delayTime,
+  delayFeedback,
+  delayMix,
+  irIndex,
+  irBypass,
+  customIRLoaded,
+  reverbEnabled,
+  reverbType,
+  reverbMix,
+  reverbDecay,
+  numParameters
+};
+
+// Entries between peqBand1Freq and peqBand4Q, per band
+constexpr int peqBandStride = peqBand2Freq - peqBand1Freq;
+
+enum class Type { Float, Bool, Int, Choice };
+
+struct Spec {
+  ID id;
+  std::string_view paramID, name;
+  Type type;
+  float minimum, maximum, defaultValue;
+  float centre = 0.0f; // Skews a float range about this value if non-zero
+};
+
+inline constexpr std::array<Spec, numParameters> specs{{
+    // Input
+    {inputLevel, "inputLevel", "Input Level", Type::Float, 0, 10, 5},
+    {inputGain, "inputGain", "Input Gain", Type::Float, 0, 10, 5},
+
+    // EQ
+    {bass, "bass", "Bass", Type::Float, 0, 10, 5},
+    {mid, "mid", "Mid", Type::Float, 0, 10, 5},
+    {treble, "treble", "Treble", Type::Float, 0, 10, 5},
+    {presence, "presence", "Presence", Type::Float, 0, 10, 5},
+
+    // Overdrive
+    {drive, "drive", "Drive", Type::Float, 0, 10, 5},
+    {punish, "punish", "Punish", Type::Bool, 0, 1, 0},
+    {plus10db, "plus10db", "+10dB", Type::Bool, 0, 1, 0},
+    {plusLow, "plusLow", "+LOW", Type::Bool, 0, 1, 0},
+
+    // Thicken (sub-octave) and chug enhancer
+    {thicken, "thicken", "Thicken", Type::Float, 0, 10, 0},
+    {thickenEnabled, "thickenEnabled", "Thicken Enabled", Type::Bool, 0, 1, 0},
+    {chugEnhance, "chugEnhance", "Chug Enhance", Type::Float, 0, 10, 0},
+    {chugEnabled, "chugEnabled", "Chug Enabled", Type::Bool, 0, 1, 0},
+
+    // Effects
+    {lofi, "lofi", "Lo-Fi", Type::Bool, 0, 1, 0},
+    {cleanse, "cleanse", "Cleanse", Type::Bool, 0, 1, 0},
+
+    // Output
+    {masterVolume, "masterVolume", "Master Volume", Type::Float, 0, 10, 5},
+    {outputLevel, "outputLevel", "Output Level", Type::Float, 0, 10, 5},
+
+    // Parametric EQ (4-band)
+    {peqEnabled, "peqEnabled", "PEQ Enabled", Type::Bool, 0, 1, 0},
+    {peqBand1Freq, "peqBand1Freq", "PEQ Band 1 Freq", Type::Float, 20, 20000,
+     100, 1000},
+    {peqBand1Gain, "peqBand1Gain", "PEQ Band 1 Gain", Type::Float, -12, 12, 0},
+    {peqBand1Q, "peqBand1Q", "PEQ Band 1 Q", Type::Float, 0.1f, 10, 1},
+    {peqBand2Freq, "peqBand2Freq", "PEQ Band 2 Freq", Type::Float, 20, 20000,
+     500, 1000},
+    {peqBand2Gain, "peqBand2Gain", "PEQ Band 2 Gain", Type::Float, -12, 12, 0},
+    {peqBand2Q, "peqBand2Q", "PEQ Band 2 Q", Type::Float, 0.1f, 10, 1},
+    {peqBand3Freq, "peqBand3Freq", "PEQ Band 3 Freq", Type::Float, 20, 20000,
+     2000, 1000},
+    {peqBand3Gain, "peqBand3Gain", "PEQ Band 3 Gain", Type::Float, -12, 12, 0},
+    {peqBand3Q, "peqBand3Q", "PEQ Band 3 Q", Type::Float, 0.1f, 10, 1},
+    {peqBand4Freq, "peqBand4Freq", "PEQ Band 4 Freq", Type::Float, 20, 20000,
+     8000, 1000},
+    {peqBand4Gain, "peqBand4Gain", "PEQ Band 4 Gain", Type::Float, -12, 12, 0},
+    {peqBand4Q, "peqBand4Q", "PEQ Band 4 Q", Type::Float, 0.1f, 10, 1},
+
+    // Delay
+    {delayEnabled, "delayEnabled", "Delay Enabled", Type::Bool, 0, 1, 0},
+    {delayTime, "delayTime", "Delay Time", Type::Float, 50, 2000, 400},
+    {delayFeedback, "delayFeedback", "Delay Feedback", Type::Float, 0, 10, 4},
+    {delayMix, "delayMix", "Delay Mix", Type::Float, 0, 10, 3},
+
+    // Cabinet IR
+    {irIndex, "irIndex", "IR Index", Type::Int, 0, 9, 0},
+    {irBypass, "irBypass", "IR Bypass", Type::Bool, 0, 1, 0},
+    {customIRLoaded, "customIRLoaded", "Custom IR Loaded", Type::Bool, 0, 1, 0},
+
+    // Reverb; the choices are ReverbStage::getTypeNames()
+    {reverbEnabled, "reverbEnabled", "Reverb Enabled", Type::Bool, 0, 1, 0},
+    {reverbType, "reverbType", "Reverb Type", Type::Choice, 0,
+     ReverbStage::numTypes - 1, ReverbStage::Room},
+    {reverbMix, "reverbMix", "Reverb Mix", Type::Float, 0, 10, 2},
+    {reverbDecay, "reverbDecay", "Reverb Decay", Type::Float, 0, 10, 5},
+}};
+
+constexpr bool isInIDOrder() {
+  for (size_t i = 0; i < specs.size(); ++i)
+    if (specs[i].id != (ID)i)
+      return false;
+  return true;
+}
+static_assert(isInIDOrder(), "specs must list every ID in enum order");
+
+// Every raw value, copied once per block so the DSP reads plain floats
+struct Snapshot {
+  std::array<float, numParameters> values{};
+
+  float operator[](ID id) const { return values[(size_t)id]; }
+  bool isOn(ID id) const { return values[(size_t)id] >= 0.5f; }
+};
+} // namespace ParameterTable
@@ -10,6 +10,9 @@ StrangerAmpsEditor::StrangerAmpsEditor(StrangerAmpsProcessor &p)
   // Create WebView bridge
   bridge = std::make_unique<WebViewBridge>(audioProcessor);
 
+  // The audio thread only measures levels while an editor reads them
+  audioProcessor.getMeterFeed().setEnabled(true);
+
   // Create WebView component with options
   auto options =
       juce::WebBrowserComponent::Options()
@@ -24,28 +27,52 @@ StrangerAmpsEditor::StrangerAmpsEditor(StrangerAmpsProcessor &p)
           .withUserScript(R"(
                           window.JUCE = window.JUCE || {};
                           window.JUCE.postMessage = function(message) {
-                              if (typeof message === 'object') {
+                              if (typeof message === 'object' &&
+                                  message.type === 'parameterChange') {
+                                  window.setParameterFromWeb(message.paramId, message.value);
+                              } else if (typeof message === 'object') {
                                   window.sendMessageToJuce(JSON.stringify(message));
                               } else {
                                   window.sendMessageToJuce(message);
                               }
                           };
+                          window.JUCE.beginParameterGesture = function(paramId) {
+                              window.setParameterGestureFromWeb(paramId, true);
+                          };
+                          window.JUCE.endParameterGesture = function(paramId) {
+                              window.setParameterGestureFromWeb(paramId, false);
+                          };
                       )")
+          // JUCE calls native functions on the message thread
           .withNativeFunction(
               "sendMessageToJuce",
               [this](const juce::Array<juce::var> &args,
                      juce::WebBrowserComponent::NativeFunctionCompletion
                          completion) {
-                if (args.size() > 0 && bridge != nullptr) {
-                  // The message should be a JSON string
-                  juce::String message = args[0].toString();
-
-                  // We need to run this on the message thread because it might
-                  // affect UI/Params
-                  juce::MessageManager::callAsync([this, message]() {
-                    bridge->handleMessageFromWeb(message);
-                  });
-                }
+                // The message should be a JSON string
+                if (args.size() > 0 && bridge != nullptr)
+                  bridge->handleMessageFromWeb(args[0].toString());
+                completion(juce::var());
+              })
+          // Knob moves skip the JSON round trip
+          .withNativeFunction(
+              "setParameterFromWeb",
+              [this](const juce::Array<juce::var> &args,
+                     juce::WebBrowserComponent::NativeFunctionCompletion
+                         completion) {
+                if (args.size() > 1 && bridge != nullptr)
+                  bridge->queueParameterChange(args[0].toString(),
+                                               (float)args[1]);
+                completion(juce::var());
+              })
+          .withNativeFunction(
+              "setParameterGestureFromWeb",
+              [this](const juce::Array<juce::var> &args,
+                     juce::WebBrowserComponent::NativeFunctionCompletion
+                         completion) {
+                if (args.size() > 1 && bridge != nullptr)
+                  bridge->setParameterGesture(args[0].toString(),
+                                              (bool)args[1]);
                 completion(juce::var());
               });
 
@@ -118,11 +145,14 @@ StrangerAmpsEditor::StrangerAmpsEditor(StrangerAmpsProcessor &p)
     }
   });
 
-  // Start timer to check WebView status and sync parameters
-  startTimer(100); // 10 Hz update rate
+  // Start timer to check WebView status; parameters sync on vblank
+  startTimer(100);
 }
 
-StrangerAmpsEditor::~StrangerAmpsEditor() { stopTimer(); }
+StrangerAmpsEditor::~StrangerAmpsEditor() {
+  stopTimer();
+  audioProcessor.getMeterFeed().setEnabled(false);
+}
 
 //==============================================================================
 void StrangerAmpsEditor::paint(juce::Graphics &g) {
@@ -153,8 +183,17 @@ void StrangerAmpsEditor::timerCallback() {
     fallbackLabel.setVisible(false);
   }
 
+  // Nothing else to poll for once the page is up
+  if (webViewLoaded)
+    stopTimer();
+}
+
+void StrangerAmpsEditor::syncToWebView() {
+  if (bridge == nullptr || !webViewLoaded)
+    return;
+
   // Sync parameters from processor to WebView
-  if (bridge != nullptr && webViewLoaded) {
-    bridge->syncParametersToWeb(webView.get());
-  }
+  bridge->syncParametersToWeb(webView.get());
+  bridge->sendMeterFrame(webView.get(), audioProcessor.getMeterFeed());
+  bridge->syncCustomIRToWeb(webView.get());
 }
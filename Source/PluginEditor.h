@@ -22,6 +22,7 @@ public:
 private:
   //==============================================================================
   void timerCallback() override;
+  void syncToWebView();
 
   // Reference to processor
   StrangerAmpsProcessor &audioProcessor;
@@ -36,5 +37,9 @@ private:
   juce::Label fallbackLabel;
   bool webViewLoaded = false;
 
+  // Sends changed parameters and meters to the WebView once per display
+  // frame
+  juce::VBlankAttachment vBlank{this, [this] { syncToWebView(); }};
+
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StrangerAmpsEditor)
 };
@@ -1,6 +1,13 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+namespace {
+// State properties holding the custom cabinet IR file and, as JSON, the
+// options it was imported with
+const juce::Identifier customIRPathId{"customIRPath"};
+const juce::Identifier customIROptionsId{"customIROptions"};
+} // namespace
+
 //==============================================================================
 StrangerAmpsProcessor::StrangerAmpsProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -14,10 +21,17 @@ StrangerAmpsProcessor::StrangerAmpsProcessor()
 #endif
               ),
 #endif
-      apvts(*this, nullptr, "Parameters", createParameterLayout()) {
+      apvts(*this, nullptr, "Parameters", createParameterLayout()),
+      ampChain(apvts) {
+  for (const auto &spec : ParameterTable::specs) {
+    const auto id = juce::String(spec.paramID.data(), spec.paramID.size());
+    rawValues[spec.id] = apvts.getRawParameterValue(id);
+    parameters[spec.id] = apvts.getParameter(id);
+    jassert(rawValues[spec.id] != nullptr && parameters[spec.id] != nullptr);
+  }
 }
 
-StrangerAmpsProcessor::~StrangerAmpsProcessor() {}
+StrangerAmpsProcessor::~StrangerAmpsProcessor() { cancelPendingUpdate(); }
 
 //==============================================================================
 const juce::String StrangerAmpsProcessor::getName() const {
@@ -48,7 +62,9 @@ bool StrangerAmpsProcessor::isMidiEffect() const {
 #endif
 }
 
-double StrangerAmpsProcessor::getTailLengthSeconds() const { return 0.0; }
+double StrangerAmpsProcessor::getTailLengthSeconds() const {
+  return ampChain.getTailSeconds(readParameters());
+}
 
 int StrangerAmpsProcessor::getNumPrograms() { return 1; }
 
@@ -66,13 +82,22 @@ void StrangerAmpsProcessor::changeProgramName(int index,
 //==============================================================================
 void StrangerAmpsProcessor::prepareToPlay(double sampleRate,
                                           int samplesPerBlock) {
-  // Initialize DSP components here
+  ampChain.prepare(sampleRate, samplesPerBlock,
+                   getTotalNumOutputChannels());
+
+  setLatencySamples(ampChain.getLatencySamples());
 }
 
 void StrangerAmpsProcessor::releaseResources() {
   // Release any resources
 }
 
+void StrangerAmpsProcessor::handleAsyncUpdate() {
+  // Oversampling changes alter the drive stage latency
+  if (ampChain.getLatencySamples() != getLatencySamples())
+    setLatencySamples(ampChain.getLatencySamples());
+}
+
 #ifndef JucePlugin_PreferredChannelConfigurations
 bool StrangerAmpsProcessor::isBusesLayoutSupported(
     const BusesLayout &layouts) const {
@@ -80,12 +105,20 @@ bool StrangerAmpsProcessor::isBusesLayoutSupported(
   juce::ignoreUnused(layouts);
   return true;
 #else
-  // Stereo in/out
-  if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+  // Mono or stereo out
+  const auto output = layouts.getMainOutputChannelSet();
+  if (output != juce::AudioChannelSet::mono() &&
+      output != juce::AudioChannelSet::stereo())
     return false;
 
 #if !JucePlugin_IsSynth
-  if (layouts.getMainInputChannelSet() != juce::AudioChannelSet::stereo())
+  // Mono or stereo in, but never more channels in than out
+  const auto input = layouts.getMainInputChannelSet();
+  if (input != juce::AudioChannelSet::mono() &&
+      input != juce::AudioChannelSet::stereo())
+    return false;
+
+  if (input.size() > output.size())
     return false;
 #endif
 
@@ -94,18 +127,91 @@ bool StrangerAmpsProcessor::isBusesLayoutSupported(
 }
 #endif
 
+bool StrangerAmpsProcessor::supportsDoublePrecisionProcessing() const {
+  return false;
+}
+
 void StrangerAmpsProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                          juce::MidiBuffer &midiMessages) {
   juce::ScopedNoDenormals noDenormals;
   auto totalNumInputChannels = getTotalNumInputChannels();
   auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-  // Clear unused output channels
-  for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-    buffer.clear(i, 0, buffer.getNumSamples());
+  // A mono input feeds every output, which the chain then runs dual-mono
+  for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i) {
+    if (totalNumInputChannels == 1)
+      buffer.copyFrom(i, 0, buffer, 0, 0, buffer.getNumSamples());
+    else
+      buffer.clear(i, 0, buffer.getNumSamples());
+  }
+
+  juce::ignoreUnused(midiMessages);
+  ampChain.process(buffer, readParameters());
+
+  // Latency is reported to the host from the message thread
+  if (ampChain.getLatencySamples() != getLatencySamples())
+    triggerAsyncUpdate();
+}
 
-  // TODO: Implement amp processing chain from JUCE_PORTING_GUIDE.md
-  // For now, just pass through
+ParameterTable::Snapshot StrangerAmpsProcessor::takeSnapshot() const {
+  ParameterTable::Snapshot snapshot;
+  for (size_t i = 0; i < rawValues.size(); ++i)
+    snapshot.values[i] = rawValues[i]->load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+AmpParameters StrangerAmpsProcessor::readParameters() const {
+  using namespace ParameterTable;
+
+  // Conversion formulas from JUCE_PORTING_GUIDE.md
+  const auto v = takeSnapshot();
+
+  AmpParameters p;
+  p.inputGain = (v[inputLevel] / 10.0f) * 1.5f * (v[inputGain] / 10.0f) * 2.0f;
+
+  p.bassDB = ((v[bass] - 5.0f) / 5.0f) * 12.0f;
+  p.midDB = ((v[mid] - 5.0f) / 5.0f) * 12.0f;
+  p.trebleDB = ((v[treble] - 5.0f) / 5.0f) * 12.0f;
+  p.presenceDB = ((v[presence] - 5.0f) / 5.0f) * 8.0f;
+
+  p.driveAmount = v[drive] * 10.0f;
+  if (v.isOn(punish))
+    p.driveAmount *= 1.5f;
+  if (v.isOn(plus10db))
+    p.driveAmount += 100.0f;
+  p.lowBoost = v.isOn(plusLow);
+  p.cleanse = v.isOn(cleanse);
+
+  p.thickenEnabled = v.isOn(thickenEnabled);
+  p.thickenAmount = v[thicken] / 10.0f;
+  p.chugEnabled = v.isOn(chugEnabled);
+  p.chugAmount = v[chugEnhance] / 10.0f;
+  p.lofi = v.isOn(lofi);
+
+  p.peqEnabled = v.isOn(peqEnabled);
+  for (size_t band = 0; band < p.peqBands.size(); ++band) {
+    const auto first = (int)peqBand1Freq + (int)band * peqBandStride;
+    p.peqBands[band] = {v[(ID)first], v[(ID)(first + 1)],
+                        v[(ID)(first + 2)]};
+  }
+
+  p.delayEnabled = v.isOn(delayEnabled);
+  p.delayTimeSeconds = v[delayTime] / 1000.0f;
+  p.delayFeedback = (v[delayFeedback] / 10.0f) * 0.8f;
+  p.delayMix = v[delayMix] / 10.0f;
+
+  p.outputGain = (v[masterVolume] / 10.0f) * (v[outputLevel] / 10.0f) * 1.5f;
+
+  p.irIndex = (int)v[irIndex];
+  p.irBypass = v.isOn(irBypass);
+  p.customIR = v.isOn(customIRLoaded);
+
+  p.reverbEnabled = v.isOn(reverbEnabled);
+  p.reverbType = (int)v[reverbType];
+  p.reverbMix = v[reverbMix] / 10.0f;
+  p.reverbDecay = v[reverbDecay];
+
+  return p;
 }
 
 //==============================================================================
@@ -130,6 +236,13 @@ void StrangerAmpsProcessor::setStateInformation(const void *data,
   if (xmlState.get() != nullptr)
     if (xmlState->hasTagName(apvts.state.getType()))
       apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+
+  // Whether it plays is up to customIRLoaded
+  const auto irPath = apvts.state.getProperty(customIRPathId).toString();
+  const auto irOptions = CustomIRLoader::Options::fromVar(
+      juce::JSON::parse(apvts.state.getProperty(customIROptionsId).toString()));
+  if (juce::File::isAbsolutePath(irPath))
+    ampChain.loadCustomIR(juce::File(irPath), irOptions);
 }
 
 //==============================================================================
@@ -139,82 +252,58 @@ void StrangerAmpsProcessor::notifyParameterChanged(const juce::String &paramID,
   // The editor will handle sending this to the WebView
 }
 
-void StrangerAmpsProcessor::setParameterFromWebView(const juce::String &paramID,
-                                                    float value) {
-  // Called from WebView (message thread) to update parameter
-  if (auto *param = apvts.getParameter(paramID)) {
-    param->setValueNotifyingHost(value);
-  }
-}
-
 //==============================================================================
 juce::AudioProcessorValueTreeState::ParameterLayout
 StrangerAmpsProcessor::createParameterLayout() {
   juce::AudioProcessorValueTreeState::ParameterLayout layout;
+  using ParameterTable::Type;
+
+  for (const auto &spec : ParameterTable::specs) {
+    const auto id = juce::String(spec.paramID.data(), spec.paramID.size());
+    const auto name = juce::String(spec.name.data(), spec.name.size());
+
+    switch (spec.type) {
+    case Type::Float: {
+      juce::NormalisableRange<float> range(spec.minimum, spec.maximum);
+      if (spec.centre > 0.0f)
+        range.setSkewForCentre(spec.centre);
+      layout.add(std::make_unique<juce::AudioParameterFloat>(
+          id, name, range, spec.defaultValue));
+      break;
+    }
+    case Type::Bool:
+      layout.add(std::make_unique<juce::AudioParameterBool>(
+          id, name, spec.defaultValue >= 0.5f));
+      break;
+    case Type::Int:
+      layout.add(std::make_unique<juce::AudioParameterInt>(
+          id, name, (int)spec.minimum, (int)spec.maximum,
+          (int)spec.defaultValue));
+      break;
+    case Type::Choice:
+      jassert(spec.id == ParameterTable::reverbType);
+      layout.add(std::make_unique<juce::AudioParameterChoice>(
+          id, name, ReverbStage::getTypeNames(), (int)spec.defaultValue));
+      break;
+    }
+  }
 
-  // Based on JUCE_PORTING_GUIDE.md parameters
-
-  // Input Section
-  layout.add(std::make_unique<juce::AudioParameterFloat>(
-      "inputLevel", "Input Level", 0.0f, 10.0f, 5.0f));
-  layout.add(std::make_unique<juce::AudioParameterFloat>(
-      "inputGain", "Input Gain", 0.0f, 10.0f, 5.0f));
-
-  // EQ Section
-  layout.add(std::make_unique<juce::AudioParameterFloat>("bass", "Bass", 0.0f,
-                                                         10.0f, 5.0f));
-  layout.add(std::make_unique<juce::AudioParameterFloat>("mid", "Mid", 0.0f,
-                                                         10.0f, 5.0f));
-  layout.add(std::make_unique<juce::AudioParameterFloat>("treble", "Treble",
-                                                         0.0f, 10.0f, 5.0f));
-  layout.add(std::make_unique<juce::AudioParameterFloat>("presence", "Presence",
-                                                         0.0f, 10.0f, 5.0f));
-
-  // Overdrive Section
-  layout.add(std::make_unique<juce::AudioParameterFloat>("drive", "Drive", 0.0f,
-                                                         10.0f, 5.0f));
-  layout.add(
-      std::make_unique<juce::AudioParameterBool>("punish", "Punish", false));
-  layout.add(
-      std::make_unique<juce::AudioParameterBool>("plus10db", "+10dB", false));
-  layout.add(
-      std::make_unique<juce::AudioParameterBool>("plusLow", "+LOW", false));
-
-  // Thicken (Sub-Octave)
-  layout.add(std::make_unique<juce::AudioParameterFloat>("thicken", "Thicken",
-                                                         0.0f, 10.0f, 0.0f));
-  layout.add(std::make_unique<juce::AudioParameterBool>(
-      "thickenEnabled", "Thicken Enabled", false));
-
-  // Chug Enhancer
-  layout.add(std::make_unique<juce::AudioParameterFloat>(
-      "chugEnhance", "Chug Enhance", 0.0f, 10.0f, 0.0f));
-  layout.add(std::make_unique<juce::AudioParameterBool>("chugEnabled",
-                                                        "Chug Enabled", false));
-
-  // Effects
-  layout.add(
-      std::make_unique<juce::AudioParameterBool>("lofi", "Lo-Fi", false));
-  layout.add(
-      std::make_unique<juce::AudioParameterBool>("cleanse", "Cleanse", false));
-
-  // Output Section
-  layout.add(std::make_unique<juce::AudioParameterFloat>(
-      "masterVolume", "Master Volume", 0.0f, 10.0f, 5.0f));
-  layout.add(std::make_unique<juce::AudioParameterFloat>(
-      "outputLevel", "Output Level", 0.0f, 10.0f, 5.0f));
-
-  // Cabinet IR
-  layout.add(std::make_unique<juce::AudioParameterInt>("irIndex", "IR Index", 0,
-                                                       9, 0));
-  layout.add(std::make_unique<juce::AudioParameterBool>("irBypass", "IR Bypass",
-                                                        false));
-
-  // TODO: Add remaining parameters (Delay, Reverb, Parametric EQ)
+  // Oversampling (drive stage)
+  AmpChain::addParameters(layout);
 
   return layout;
 }
 
+void StrangerAmpsProcessor::loadCustomIR(
+    const juce::File &file, const CustomIRLoader::Options &options) {
+  apvts.state.setProperty(customIRPathId, file.getFullPathName(), nullptr);
+  apvts.state.setProperty(customIROptionsId,
+                          juce::JSON::toString(options.toVar(), true), nullptr);
+  ampChain.loadCustomIR(file, options);
+
+  parameters[ParameterTable::customIRLoaded]->setValueNotifyingHost(1.0f);
+}
+
 //==============================================================================
 // This creates new instances of the plugin
 juce::AudioProcessor *JUCE_CALLTYPE createPluginFilter() {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "DSP/AmpChain.h"
+#include "ParameterTable.h"
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 
@@ -8,7 +10,8 @@
  * Main audio processor for Stranger Amps plugin.
  * Handles audio processing, parameter management, and state persistence.
  */
-class StrangerAmpsProcessor : public juce::AudioProcessor {
+class StrangerAmpsProcessor : public juce::AudioProcessor,
+                              private juce::AsyncUpdater {
 public:
   //==============================================================================
   StrangerAmpsProcessor();
@@ -24,6 +27,9 @@ public:
 
   void processBlock(juce::AudioBuffer<float> &, juce::MidiBuffer &) override;
 
+  // Float only; see AmpChain
+  bool supportsDoublePrecisionProcessing() const override;
+
   //==============================================================================
   juce::AudioProcessorEditor *createEditor() override;
   bool hasEditor() const override;
@@ -54,19 +60,43 @@ public:
   // Send parameter update to WebView
   void notifyParameterChanged(const juce::String &paramID, float value);
 
-  // Callback for WebView to set parameters
-  void setParameterFromWebView(const juce::String &paramID, float value);
+  // Message thread: imports a cabinet IR file in the background and selects
+  // it once ready. The file and options are remembered with the plugin
+  // state.
+  void loadCustomIR(const juce::File &file,
+                    const CustomIRLoader::Options &options = {});
+  const CustomIRLoader &getCustomIRLoader() const {
+    return ampChain.getCustomIRLoader();
+  }
+
+  // Levels and scope published by the audio thread, for the editor
+  MeterFeed &getMeterFeed() { return ampChain.getMeterFeed(); }
 
 private:
   //==============================================================================
   // Parameter layout creation
   juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+  // Copies every raw value once (any thread)
+  ParameterTable::Snapshot takeSnapshot() const;
+
+  // Converts the current parameter values into DSP units (any thread)
+  AmpParameters readParameters() const;
+
+  // Reports latency changes to the host from the message thread
+  void handleAsyncUpdate() override;
+
   // Audio processing state
   juce::AudioProcessorValueTreeState apvts;
 
-  // DSP components will be added here
-  // TODO: Add amp processing chain from JUCE_PORTING_GUIDE.md
+  // Raw values and parameter objects for every ParameterTable entry, cached
+  // by ID so neither thread looks up strings
+  std::array<std::atomic<float> *, ParameterTable::numParameters> rawValues{};
+  std::array<juce::RangedAudioParameter *, ParameterTable::numParameters>
+      parameters{};
+
+  // DSP
+  AmpChain ampChain;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StrangerAmpsProcessor)
 };
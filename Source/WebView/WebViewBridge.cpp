@@ -2,35 +2,92 @@
 #include "../PluginProcessor.h"
 
 //==============================================================================
-WebViewBridge::WebViewBridge(StrangerAmpsProcessor &p) : processor(p) {}
+WebViewBridge::WebViewBridge(StrangerAmpsProcessor &p)
+    : processor(p), parameters(p.getParameters()),
+      lastSentValues((size_t)parameters.size()),
+      pendingValues((size_t)parameters.size(),
+                    std::numeric_limits<float>::quiet_NaN()),
+      inGesture((size_t)parameters.size(), false),
+      dirty((size_t)(parameters.size() + bitsPerWord - 1) / bitsPerWord) {
+  for (auto *param : parameters) {
+    auto *paramWithID =
+        dynamic_cast<juce::AudioProcessorParameterWithID *>(param);
+    paramIDs.add(paramWithID != nullptr ? paramWithID->paramID
+                                        : juce::String());
+    if (paramWithID != nullptr)
+      paramIndices.emplace(paramWithID->paramID, paramIDs.size() - 1);
+    param->addListener(this);
+  }
+
+  markAllParametersDirty();
+}
 
-WebViewBridge::~WebViewBridge() {}
+WebViewBridge::~WebViewBridge() {
+  cancelPendingUpdate();
+
+  // Don't leave the host inside a gesture the page never ended
+  for (int i = 0; i < parameters.size(); ++i) {
+    applyPendingChange(i);
+    if (inGesture[(size_t)i])
+      parameters[i]->endChangeGesture();
+  }
+
+  for (auto *param : parameters)
+    param->removeListener(this);
+}
 
 //==============================================================================
 // Native → Web Communication
 //==============================================================================
 
+void WebViewBridge::markAllParametersDirty() {
+  std::fill(lastSentValues.begin(), lastSentValues.end(),
+            std::numeric_limits<float>::quiet_NaN());
+
+  for (size_t word = 0; word < dirty.size(); ++word)
+    dirty[word].store(~0u, std::memory_order_relaxed);
+
+  lastImportCount = -1;
+}
+
+void WebViewBridge::parameterValueChanged(int parameterIndex, float) {
+  if (!juce::isPositiveAndBelow(parameterIndex, parameters.size()))
+    return;
+
+  dirty[(size_t)(parameterIndex / bitsPerWord)].fetch_or(
+      1u << (parameterIndex % bitsPerWord), std::memory_order_release);
+}
+
 void WebViewBridge::syncParametersToWeb(juce::WebBrowserComponent *webView) {
   if (webView == nullptr)
     return;
 
-  auto &apvts = processor.getValueTreeState();
-
-  // Iterate through all parameters and send updates if changed
-  for (auto *param : processor.getParameters()) {
-    if (auto *paramWithID =
-            dynamic_cast<juce::AudioProcessorParameterWithID *>(param)) {
-      juce::String paramID = paramWithID->paramID;
-      float currentValue = param->getValue();
-
-      // Only send if value has changed (reduce unnecessary updates)
-      if (lastSentValues.find(paramID) == lastSentValues.end() ||
-          std::abs(lastSentValues[paramID] - currentValue) > 0.001f) {
-        sendParameterUpdate(webView, paramID, currentValue);
-        lastSentValues[paramID] = currentValue;
-      }
+  juce::String updates;
+
+  for (size_t word = 0; word < dirty.size(); ++word) {
+    auto bits = dirty[word].exchange(0, std::memory_order_acquire);
+
+    for (int bit = 0; bits != 0; ++bit, bits >>= 1) {
+      const auto index = (int)word * bitsPerWord + bit;
+      if ((bits & 1u) == 0 || index >= parameters.size() ||
+          paramIDs[index].isEmpty())
+        continue;
+
+      // Values read now, so a parameter that moved many times since the
+      // last sync is sent once
+      const auto value = parameters[index]->getValue();
+      auto &lastSent = lastSentValues[(size_t)index];
+      if (std::abs(lastSent - value) <= 0.001f)
+        continue;
+
+      lastSent = value;
+      updates << (updates.isEmpty() ? "" : ",") << "\"" << paramIDs[index]
+              << "\":" << juce::String(value, 6);
     }
   }
+
+  if (updates.isNotEmpty())
+    evaluateJavaScript(webView, buildParameterBatchScript(updates));
 }
 
 void WebViewBridge::sendParameterUpdate(juce::WebBrowserComponent *webView,
@@ -43,6 +100,75 @@ void WebViewBridge::sendParameterUpdate(juce::WebBrowserComponent *webView,
   evaluateJavaScript(webView, script);
 }
 
+void WebViewBridge::sendMeterFrame(juce::WebBrowserComponent *webView,
+                                   MeterFeed &feed) {
+  constexpr int headerSize = 2 * MeterFeed::numTaps + 2;
+  constexpr int maxScopePoints = 4 * MeterFeed::maxScopePoints;
+
+  meterPacket.assign(headerSize, 0.0f);
+  bool any = false;
+
+  while (feed.pop(meterFrame)) {
+    any = true;
+    for (size_t tap = 0; tap < MeterFeed::numTaps; ++tap) {
+      const auto &level = meterFrame.levels[tap];
+      meterPacket[2 * tap] = juce::jmax(meterPacket[2 * tap], level.peak);
+      meterPacket[2 * tap + 1] = level.rms;
+    }
+    meterPacket[headerSize - 2] = meterFrame.gain;
+    meterPacket.insert(meterPacket.end(), meterFrame.scope.begin(),
+                       meterFrame.scope.begin() + meterFrame.numScopePoints);
+  }
+
+  if (!any || webView == nullptr)
+    return;
+
+  // Beyond a few frames' worth the UI has stalled; keep the newest points
+  const auto excess = (int)meterPacket.size() - headerSize - maxScopePoints;
+  if (excess > 0)
+    meterPacket.erase(meterPacket.begin() + headerSize,
+                      meterPacket.begin() + headerSize + excess);
+
+  meterPacket[headerSize - 1] = (float)(meterPacket.size() - headerSize);
+
+  // Native byte order; every platform with a WebView is little-endian
+  const auto packet = juce::Base64::toBase64(
+      meterPacket.data(), meterPacket.size() * sizeof(float));
+  evaluateJavaScript(webView, "if (window.JUCE && window.JUCE.onMeterFrame) { "
+                              "window.JUCE.onMeterFrame('" +
+                                  packet + "'); }");
+}
+
+void WebViewBridge::syncCustomIRToWeb(juce::WebBrowserComponent *webView) {
+  const auto &loader = processor.getCustomIRLoader();
+  const auto importCount = loader.getImportCount();
+  if (webView == nullptr || importCount == lastImportCount)
+    return;
+
+  lastImportCount = importCount;
+
+  const auto file = loader.getLoadedFile();
+  const auto error = loader.getLastError();
+  if (file == juce::File() && error.isEmpty())
+    return;
+
+  const auto report = loader.getLastReport();
+  auto result = std::make_unique<juce::DynamicObject>();
+  result->setProperty("name", file.getFileNameWithoutExtension());
+  result->setProperty("resampledLength", report.resampledLength);
+  result->setProperty("finalLength", report.finalLength);
+  result->setProperty("tapsSaved", report.getTapsSaved());
+  result->setProperty("options", loader.getLoadedOptions().toVar());
+  result->setProperty("error", error);
+
+  evaluateJavaScript(webView,
+                     "if (window.JUCE && window.JUCE.onCustomIRLoaded) { "
+                     "window.JUCE.onCustomIRLoaded(" +
+                         juce::JSON::toString(juce::var(result.release()),
+                                              true) +
+                         "); }");
+}
+
 void WebViewBridge::sendPresetData(juce::WebBrowserComponent *webView,
                                    const juce::String &presetJson) {
   if (webView == nullptr)
@@ -75,8 +201,22 @@ void WebViewBridge::handleMessageFromWeb(const juce::String &message) {
 
   if (messageType == "parameterChange") {
     handleParameterChange(messageVar);
+  } else if (messageType == "parameterGestureBegin" ||
+             messageType == "parameterGestureEnd") {
+    setParameterGesture(messageObj->getProperty("paramId").toString(),
+                        messageType == "parameterGestureBegin");
   } else if (messageType == "presetLoad" || messageType == "presetSave") {
     handlePresetAction(messageVar);
+  } else if (messageType == "customIRBrowse" ||
+             messageType == "customIROptions") {
+    const auto options =
+        CustomIRLoader::Options::fromVar(messageObj->getProperty("options"));
+
+    if (messageType == "customIROptions")
+      reimportCustomIR(options);
+    else
+      juce::MessageManager::callAsync(
+          [this, options]() { browseForCustomIR(options); });
   }
 }
 
@@ -88,10 +228,65 @@ void WebViewBridge::handleParameterChange(const juce::var &messageData) {
   auto paramId = messageObj->getProperty("paramId").toString();
   float value = static_cast<float>(messageObj->getProperty("value"));
 
-  // Update parameter in processor (thread-safe)
-  juce::MessageManager::callAsync([this, paramId, value]() {
-    processor.setParameterFromWebView(paramId, value);
-  });
+  queueParameterChange(paramId, value);
+}
+
+void WebViewBridge::queueParameterChange(const juce::String &paramId,
+                                         float value) {
+  const auto index = getParameterIndex(paramId);
+  if (index < 0 || !std::isfinite(value))
+    return;
+
+  pendingValues[(size_t)index] = juce::jlimit(0.0f, 1.0f, value);
+  triggerAsyncUpdate();
+}
+
+void WebViewBridge::setParameterGesture(const juce::String &paramId,
+                                        bool starting) {
+  const auto index = getParameterIndex(paramId);
+  if (index < 0 || inGesture[(size_t)index] == starting)
+    return;
+
+  // The gesture ends on the last value the page sent
+  if (!starting)
+    applyPendingChange(index);
+
+  inGesture[(size_t)index] = starting;
+  if (starting)
+    parameters[index]->beginChangeGesture();
+  else
+    parameters[index]->endChangeGesture();
+}
+
+int WebViewBridge::getParameterIndex(const juce::String &paramId) const {
+  const auto it = paramIndices.find(paramId);
+  return it != paramIndices.end() ? it->second : -1;
+}
+
+void WebViewBridge::applyPendingChange(int index) {
+  auto &value = pendingValues[(size_t)index];
+  if (std::isnan(value))
+    return;
+
+  auto *param = parameters[index];
+
+  // The page already shows this value; don't echo it back
+  lastSentValues[(size_t)index] = value;
+
+  // A lone change (a click, not a drag) is its own gesture
+  const bool standalone = !inGesture[(size_t)index];
+  if (standalone)
+    param->beginChangeGesture();
+  param->setValueNotifyingHost(value);
+  if (standalone)
+    param->endChangeGesture();
+
+  value = std::numeric_limits<float>::quiet_NaN();
+}
+
+void WebViewBridge::handleAsyncUpdate() {
+  for (int i = 0; i < parameters.size(); ++i)
+    applyPendingChange(i);
 }
 
 void WebViewBridge::handlePresetAction(const juce::var &messageData) {
@@ -110,6 +305,28 @@ void WebViewBridge::handlePresetAction(const juce::var &messageData) {
   }
 }
 
+void WebViewBridge::browseForCustomIR(
+    const CustomIRLoader::Options &options) {
+  // The page can't hand native code a file path, so pick it natively
+  irChooser = std::make_unique<juce::FileChooser>(
+      "Load Cabinet IR", juce::File(), "*.wav;*.aif;*.aiff;*.flac;*.ogg");
+
+  irChooser->launchAsync(
+      juce::FileBrowserComponent::openMode |
+          juce::FileBrowserComponent::canSelectFiles,
+      [this, options](const juce::FileChooser &chooser) {
+        const auto file = chooser.getResult();
+        if (file.existsAsFile())
+          processor.loadCustomIR(file, options);
+      });
+}
+
+void WebViewBridge::reimportCustomIR(const CustomIRLoader::Options &options) {
+  const auto file = processor.getCustomIRLoader().getLoadedFile();
+  if (file.existsAsFile())
+    processor.loadCustomIR(file, options);
+}
+
 //==============================================================================
 // Helper Methods
 //==============================================================================
@@ -145,3 +362,15 @@ WebViewBridge::buildParameterUpdateScript(const juce::String &paramId,
          "window.JUCE.onParameterUpdate('" +
          paramId + "', " + juce::String(value, 6) + "); }";
 }
+
+juce::String
+WebViewBridge::buildParameterBatchScript(const juce::String &updates) {
+  // Pages exposing window.JUCE.onParameterBatch(updates) get the whole
+  // object; older ones get onParameterUpdate(paramId, value) per entry
+  return "if (window.JUCE) { const updates = {" + updates +
+         "}; if (window.JUCE.onParameterBatch) { "
+         "window.JUCE.onParameterBatch(updates); } "
+         "else if (window.JUCE.onParameterUpdate) { "
+         "for (const id in updates) "
+         "window.JUCE.onParameterUpdate(id, updates[id]); } }";
+}
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "../DSP/CustomIRLoader.h"
+#include "../DSP/MeterFeed.h"
+#include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_core/juce_core.h>
 #include <juce_gui_extra/juce_gui_extra.h>
+#include <unordered_map>
 
 // Forward declaration
 class StrangerAmpsProcessor;
@@ -10,20 +14,45 @@ class StrangerAmpsProcessor;
 /**
  * Bridge for bidirectional communication between WebView and JUCE.
  * Handles parameter synchronization and preset management.
+ *
+ * Parameter listeners mark changed parameters in a lock-free dirty bitset,
+ * from whichever thread changed them. syncParametersToWeb() sends all of
+ * them in a single script, so automation costs one evaluation per sync
+ * however many parameters move.
+ *
+ * Values from the page are coalesced per parameter and applied once per
+ * message loop tick, inside the page's change gestures, so a knob drag is
+ * one thinned automation gesture for the host.
  */
-class WebViewBridge {
+class WebViewBridge : private juce::AudioProcessorParameter::Listener,
+                      private juce::AsyncUpdater {
 public:
   explicit WebViewBridge(StrangerAmpsProcessor &processor);
-  ~WebViewBridge();
+  ~WebViewBridge() override;
 
   //==============================================================================
-  // Native → Web: Send parameter updates to React UI
+  // Native → Web: Send every parameter changed since the last sync to the
+  // React UI in one call (message thread)
   void syncParametersToWeb(juce::WebBrowserComponent *webView);
 
+  // Resends every parameter on the next sync, e.g. after the page loads
+  void markAllParametersDirty();
+
   // Native → Web: Send single parameter update
   void sendParameterUpdate(juce::WebBrowserComponent *webView,
                            const juce::String &paramId, float value);
 
+  // Native → Web: Drain the meter feed and send what it held as one packed
+  // frame, base64-encoded little-endian float32s:
+  //   [peak, rms] per MeterFeed::Tap, gain, scope point count, scope points
+  // Peaks are the highest since the last call, RMS and gain the latest.
+  void sendMeterFrame(juce::WebBrowserComponent *webView, MeterFeed &feed);
+
+  // Native → Web: Send the outcome of the latest custom IR import, once per
+  // import: file name, lengths before and after the cut, the options used
+  // and the error if it failed
+  void syncCustomIRToWeb(juce::WebBrowserComponent *webView);
+
   // Native → Web: Send preset data
   void sendPresetData(juce::WebBrowserComponent *webView,
                       const juce::String &presetJson);
@@ -35,9 +64,22 @@ public:
   // Parse and apply parameter change from web
   void handleParameterChange(const juce::var &messageData);
 
+  // Message thread: the latest value per parameter is applied on the next
+  // message loop tick. Values are normalised (0 - 1).
+  void queueParameterChange(const juce::String &paramId, float value);
+
+  // Message thread: a drag on the page starts or ends
+  void setParameterGesture(const juce::String &paramId, bool starting);
+
   // Handle preset load/save requests
   void handlePresetAction(const juce::var &messageData);
 
+  // Let the user pick a custom cabinet IR file, imported with these options
+  void browseForCustomIR(const CustomIRLoader::Options &options);
+
+  // Imports the current custom IR again with new options
+  void reimportCustomIR(const CustomIRLoader::Options &options);
+
 private:
   //==============================================================================
   // Execute JavaScript in the WebView
@@ -48,11 +90,44 @@ private:
   juce::String buildParameterUpdateScript(const juce::String &paramId,
                                           float value);
 
+  // Build one JavaScript call for a {paramId: value, ...} object literal
+  juce::String buildParameterBatchScript(const juce::String &updates);
+
+  // Any thread, including the audio thread during automation
+  void parameterValueChanged(int parameterIndex, float newValue) override;
+  void parameterGestureChanged(int, bool) override {}
+
+  // Index into parameters, or -1
+  int getParameterIndex(const juce::String &paramId) const;
+
+  // Applies the queued value for one parameter, if any
+  void applyPendingChange(int index);
+  void handleAsyncUpdate() override;
+
   // Reference to audio processor
   StrangerAmpsProcessor &processor;
 
-  // Track which parameters have changed
-  std::unordered_map<juce::String, float> lastSentValues;
+  // Message thread: the frame being drained and the packet being built
+  MeterFeed::Frame meterFrame;
+  std::vector<float> meterPacket;
+
+  // Indexed like processor.getParameters()
+  juce::Array<juce::AudioProcessorParameter *> parameters;
+  juce::StringArray paramIDs;
+  std::unordered_map<juce::String, int> paramIndices; // By paramIDs entry
+  std::vector<float> lastSentValues; // NaN until first sent
+
+  // Message thread: values from the page not applied yet (NaN if none), and
+  // the parameters the page is dragging
+  std::vector<float> pendingValues;
+  std::vector<bool> inGesture;
+
+  // One bit per parameter changed since the last sync
+  static constexpr int bitsPerWord = 32;
+  std::vector<std::atomic<uint32_t>> dirty;
+
+  std::unique_ptr<juce::FileChooser> irChooser;
+  int lastImportCount = -1; // As last sent to the page
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WebViewBridge)
 };
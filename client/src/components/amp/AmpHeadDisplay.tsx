@@ -1,10 +1,12 @@
 import { LEDIndicator } from './LEDIndicator';
+import { Scope } from './Scope';
 
 interface AmpHeadDisplayProps {
   isClipping?: boolean;
+  scope?: Float32Array;
 }
 
-export function AmpHeadDisplay({ isClipping = false }: AmpHeadDisplayProps) {
+export function AmpHeadDisplay({ isClipping = false, scope }: AmpHeadDisplayProps) {
   return (
     <div 
       className="relative w-full"
@@ -48,16 +50,20 @@ export function AmpHeadDisplay({ isClipping = false }: AmpHeadDisplayProps) {
               <div className="h-8 w-px bg-gradient-to-b from-transparent via-neutral-600 to-transparent" />
             </div>
             
-            <div className="flex gap-2">
-              {[1, 2].map((i) => (
-                <div 
-                  key={i}
-                  className="w-12 h-3 rounded-sm bg-neutral-800/60 border border-neutral-700/50 flex items-center justify-center"
-                >
-                  <div className="w-8 h-px bg-neutral-600" />
-                </div>
-              ))}
-            </div>
+            {scope ? (
+              <Scope points={scope} />
+            ) : (
+              <div className="flex gap-2">
+                {[1, 2].map((i) => (
+                  <div 
+                    key={i}
+                    className="w-12 h-3 rounded-sm bg-neutral-800/60 border border-neutral-700/50 flex items-center justify-center"
+                  >
+                    <div className="w-8 h-px bg-neutral-600" />
+                  </div>
+                ))}
+              </div>
+            )}
             
             <div className="flex items-center gap-3">
               <div className="h-8 w-px bg-gradient-to-b from-transparent via-neutral-600 to-transparent" />
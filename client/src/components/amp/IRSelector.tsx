@@ -10,6 +10,10 @@ import {
 import { ToggleSwitch } from './ToggleSwitch';
 import { Button } from '@/components/ui/button';
 import { Upload } from 'lucide-react';
+import type { CustomIROptions, CustomIRReport } from '@/juce-bridge';
+
+// Energy cuts offered for native imports; 'full' keeps the whole tail
+const tailCuts = ['full', '-30', '-40', '-60'];
 
 interface IRSelectorProps {
   selectedIR: number;
@@ -19,6 +23,10 @@ interface IRSelectorProps {
   onIRChange: (index: number) => void;
   onBypassChange: (bypass: boolean) => void;
   onLoadCustomIR?: (file: File) => void;
+  onBrowseCustomIR?: () => void;
+  irOptions?: CustomIROptions;
+  onIROptionsChange?: (options: CustomIROptions) => void;
+  irReport?: CustomIRReport | null;
 }
 
 export function IRSelector({
@@ -29,6 +37,10 @@ export function IRSelector({
   onIRChange,
   onBypassChange,
   onLoadCustomIR,
+  onBrowseCustomIR,
+  irOptions,
+  onIROptionsChange,
+  irReport,
 }: IRSelectorProps) {
   const fileInputRef = useRef<HTMLInputElement>(null);
 
@@ -43,6 +55,11 @@ export function IRSelector({
   };
 
   const handleLoadClick = () => {
+    // Inside the plugin the file is picked and imported natively
+    if (onBrowseCustomIR) {
+      onBrowseCustomIR();
+      return;
+    }
     fileInputRef.current?.click();
   };
 
@@ -117,6 +134,47 @@ export function IRSelector({
           Load IR
         </Button>
       </div>
+
+      {irOptions && onIROptionsChange && (
+        <div className="flex items-center justify-center gap-2" data-testid="ir-import-options">
+          <ToggleSwitch
+            isOn={irOptions.minimumPhase}
+            label="MIN PHASE"
+            onChange={(minimumPhase) => onIROptionsChange({ ...irOptions, minimumPhase })}
+            size="sm"
+          />
+          <Select
+            value={irOptions.energyCutDb === undefined ? 'full' : irOptions.energyCutDb.toString()}
+            onValueChange={(val) =>
+              onIROptionsChange({
+                ...irOptions,
+                energyCutDb: val === 'full' ? undefined : parseInt(val, 10),
+              })
+            }
+          >
+            <SelectTrigger
+              className="h-7 w-28 bg-neutral-900 border-neutral-700 font-mono text-[10px]"
+              data-testid="ir-tail-cut-trigger"
+            >
+              <SelectValue />
+            </SelectTrigger>
+            <SelectContent className="bg-neutral-900 border-neutral-700">
+              {tailCuts.map((cut) => (
+                <SelectItem key={cut} value={cut} className="font-mono text-xs">
+                  {cut === 'full' ? 'Full tail' : `Cut ${cut} dB`}
+                </SelectItem>
+              ))}
+            </SelectContent>
+          </Select>
+        </div>
+      )}
+
+      {irReport && irReport.resampledLength > 0 && (
+        <div className="text-center font-mono text-[10px] text-muted-foreground" data-testid="ir-import-report">
+          {irReport.finalLength.toLocaleString()} taps
+          {irReport.tapsSaved > 0 && ` (${irReport.tapsSaved.toLocaleString()} cut)`}
+        </div>
+      )}
     </div>
   );
 }
@@ -3,17 +3,26 @@ import { ToggleSwitch } from './ToggleSwitch';
 import { IRSelector } from './IRSelector';
 import { RoutingSelector } from './RoutingSelector';
 import type { AmpSettings } from '@shared/schema';
+import type { CustomIROptions, CustomIRReport } from '@/juce-bridge';
 
 interface RightControlPanelProps {
   settings: AmpSettings;
   onSettingsChange: (settings: Partial<AmpSettings>) => void;
   onLoadCustomIR?: (file: File) => void;
+  onBrowseCustomIR?: () => void;
+  irOptions?: CustomIROptions;
+  onIROptionsChange?: (options: CustomIROptions) => void;
+  irReport?: CustomIRReport | null;
 }
 
 export function RightControlPanel({
   settings,
   onSettingsChange,
   onLoadCustomIR,
+  onBrowseCustomIR,
+  irOptions,
+  onIROptionsChange,
+  irReport,
 }: RightControlPanelProps) {
   return (
     <div 
@@ -72,6 +81,10 @@ export function RightControlPanel({
             onIRChange={(v) => onSettingsChange({ irIndex: v, customIRLoaded: false })}
             onBypassChange={(v) => onSettingsChange({ irBypass: v })}
             onLoadCustomIR={onLoadCustomIR}
+            onBrowseCustomIR={onBrowseCustomIR}
+            irOptions={irOptions}
+            onIROptionsChange={onIROptionsChange}
+            irReport={irReport}
           />
         </div>
 
@@ -0,0 +1,43 @@
+import { useEffect, useRef } from 'react';
+
+interface ScopeProps {
+  points: Float32Array;
+  width?: number;
+  height?: number;
+}
+
+export function Scope({ points, width = 200, height = 32 }: ScopeProps) {
+  const canvasRef = useRef<HTMLCanvasElement>(null);
+
+  useEffect(() => {
+    const context = canvasRef.current?.getContext('2d');
+    if (!context) return;
+
+    context.clearRect(0, 0, width, height);
+    context.strokeStyle = 'hsl(45 60% 50%)';
+    context.lineWidth = 1;
+    context.beginPath();
+
+    const step = width / Math.max(1, points.length - 1);
+    points.forEach((point, i) => {
+      const y = (0.5 - 0.5 * Math.max(-1, Math.min(1, point))) * height;
+      if (i === 0) {
+        context.moveTo(0, y);
+      } else {
+        context.lineTo(i * step, y);
+      }
+    });
+
+    context.stroke();
+  }, [points, width, height]);
+
+  return (
+    <canvas
+      ref={canvasRef}
+      width={width}
+      height={height}
+      className="rounded-sm bg-neutral-900/80 border border-neutral-700/50"
+      data-testid="scope"
+    />
+  );
+}
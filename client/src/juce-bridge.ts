@@ -15,17 +15,61 @@ declare global {
             // Called by JUCE to load preset data
             onPresetLoad?: (presetData: any) => void;
 
+            // Called by JUCE when a custom IR import finishes or fails
+            onCustomIRLoaded?: (report: CustomIRReport) => void;
+
+            // Called by JUCE once per display frame with a packed meter frame
+            onMeterFrame?: (packet: string) => void;
+
             // Send message to JUCE (implemented by WebView)
             postMessage?: (message: JUCEMessage) => void;
+
+            // Bracket a run of changes so the host records one undo step
+            beginParameterGesture?: (paramId: string) => void;
+            endParameterGesture?: (paramId: string) => void;
         };
     }
 }
 
+// How the native importer treats a custom IR
+export interface CustomIROptions {
+    minimumPhase: boolean;
+    // Cut the tail where the energy left falls this far below the total
+    energyCutDb?: number;
+}
+
+// The outcome of a native custom IR import
+export interface CustomIRReport {
+    name: string;
+    resampledLength: number;
+    finalLength: number;
+    tapsSaved: number;
+    options: CustomIROptions;
+    error: string;
+}
+
+// Linear peak and RMS of one meter tap since the previous frame
+export interface MeterLevel {
+    peak: number;
+    rms: number;
+}
+
+// Levels and scope trace measured by the plugin's audio thread
+export interface MeterFrame {
+    input: MeterLevel;
+    postDrive: MeterLevel;
+    output: MeterLevel;
+    gain: number;
+    scope: Float32Array;
+}
+
 // Message types for JUCE communication
 export type JUCEMessage =
     | { type: 'parameterChange'; paramId: string; value: number }
     | { type: 'presetLoad'; presetName: string }
-    | { type: 'presetSave'; presetName: string; presetData: any };
+    | { type: 'presetSave'; presetName: string; presetData: any }
+    | { type: 'customIRBrowse'; options: CustomIROptions }
+    | { type: 'customIROptions'; options: CustomIROptions };
 
 /**
  * Check if running inside JUCE WebView
@@ -34,6 +78,32 @@ export function isJUCEPlugin(): boolean {
     return typeof window !== 'undefined' && window.JUCE !== undefined;
 }
 
+// How long a parameter must go without new values before its gesture closes
+const GESTURE_IDLE_MS = 250;
+
+const openGestures = new Map<string, ReturnType<typeof setTimeout>>();
+
+/**
+ * Hold one host gesture open while a parameter keeps receiving values,
+ * closing it once the control has been idle for GESTURE_IDLE_MS. This
+ * covers drags, wheel and key changes without each control tracking
+ * its own pointer state.
+ */
+function touchParameterGesture(paramId: string): void {
+    const pending = openGestures.get(paramId);
+
+    if (pending !== undefined) {
+        clearTimeout(pending);
+    } else {
+        window.JUCE?.beginParameterGesture?.(paramId);
+    }
+
+    openGestures.set(paramId, setTimeout(() => {
+        openGestures.delete(paramId);
+        window.JUCE?.endParameterGesture?.(paramId);
+    }, GESTURE_IDLE_MS));
+}
+
 /**
  * Send parameter change to JUCE native layer
  */
@@ -43,6 +113,8 @@ export function sendParameterToJUCE(paramId: string, value: number): void {
         return;
     }
 
+    touchParameterGesture(paramId);
+
     const message: JUCEMessage = {
         type: 'parameterChange',
         paramId,
@@ -95,13 +167,66 @@ export function savePresetToJUCE(presetName: string, presetData: any): void {
     }
 }
 
+/**
+ * Ask JUCE to pick a cabinet IR file and import it natively
+ */
+export function browseCustomIRInJUCE(options: CustomIROptions): void {
+    if (!isJUCEPlugin()) return;
+
+    const message: JUCEMessage = { type: 'customIRBrowse', options };
+
+    if (window.JUCE?.postMessage) {
+        window.JUCE.postMessage(message);
+    } else {
+        console.log('[JUCE_MESSAGE]', JSON.stringify(message));
+    }
+}
+
+/**
+ * Import the current custom IR again with new options
+ */
+export function setCustomIROptionsInJUCE(options: CustomIROptions): void {
+    if (!isJUCEPlugin()) return;
+
+    const message: JUCEMessage = { type: 'customIROptions', options };
+
+    if (window.JUCE?.postMessage) {
+        window.JUCE.postMessage(message);
+    } else {
+        console.log('[JUCE_MESSAGE]', JSON.stringify(message));
+    }
+}
+
+/**
+ * Decode a meter frame sent by WebViewBridge::sendMeterFrame: base64 of
+ * little-endian float32s laid out as [peak, rms] for the input, post-drive
+ * and output taps, then gain, scope point count and the scope points
+ */
+export function decodeMeterFrame(packet: string): MeterFrame {
+    const bytes = Uint8Array.from(atob(packet), (c) => c.charCodeAt(0));
+    const view = new DataView(bytes.buffer);
+    const read = (index: number) => view.getFloat32(index * 4, true);
+    const level = (tap: number): MeterLevel => ({ peak: read(2 * tap), rms: read(2 * tap + 1) });
+
+    const headerSize = 2 * 3 + 2;
+    const numPoints = Math.min(read(headerSize - 1), bytes.length / 4 - headerSize);
+    const scope = new Float32Array(numPoints);
+    for (let i = 0; i < numPoints; i++) {
+        scope[i] = read(headerSize + i);
+    }
+
+    return { input: level(0), postDrive: level(1), output: level(2), gain: read(headerSize - 2), scope };
+}
+
 /**
  * Initialize JUCE bridge
  * Call this in your React app's entry point
  */
 export function initializeJUCEBridge(
     onParameterUpdate: (paramId: string, value: number) => void,
-    onPresetLoad?: (presetData: any) => void
+    onPresetLoad?: (presetData: any) => void,
+    onCustomIRLoaded?: (report: CustomIRReport) => void,
+    onMeterFrame?: (frame: MeterFrame) => void
 ): void {
     if (typeof window === 'undefined') return;
 
@@ -117,6 +242,14 @@ export function initializeJUCEBridge(
         window.JUCE.onPresetLoad = onPresetLoad;
     }
 
+    if (onCustomIRLoaded) {
+        window.JUCE.onCustomIRLoaded = onCustomIRLoaded;
+    }
+
+    if (onMeterFrame) {
+        window.JUCE.onMeterFrame = (packet: string) => onMeterFrame(decodeMeterFrame(packet));
+    }
+
     console.log('[JUCE Bridge] Initialized', {
         isPlugin: isJUCEPlugin(),
         hasPostMessage: !!window.JUCE.postMessage
@@ -127,8 +260,16 @@ export function initializeJUCEBridge(
  * Cleanup JUCE bridge
  */
 export function cleanupJUCEBridge(): void {
+    openGestures.forEach((pending, paramId) => {
+        clearTimeout(pending);
+        window.JUCE?.endParameterGesture?.(paramId);
+    });
+    openGestures.clear();
+
     if (typeof window !== 'undefined' && window.JUCE) {
         delete window.JUCE.onParameterUpdate;
         delete window.JUCE.onPresetLoad;
+        delete window.JUCE.onCustomIRLoaded;
+        delete window.JUCE.onMeterFrame;
     }
 }
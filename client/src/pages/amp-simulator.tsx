@@ -1,5 +1,6 @@
 import { useState, useCallback, useEffect, useRef } from 'react';
-import { initializeJUCEBridge, cleanupJUCEBridge, sendParameterToJUCE, isJUCEPlugin } from '@/juce-bridge';
+import { initializeJUCEBridge, cleanupJUCEBridge, sendParameterToJUCE, isJUCEPlugin, browseCustomIRInJUCE, setCustomIROptionsInJUCE } from '@/juce-bridge';
+import type { CustomIROptions, CustomIRReport, MeterFrame } from '@/juce-bridge';
 import { useQuery, useMutation } from '@tanstack/react-query';
 import { Settings, HelpCircle, Volume2, VolumeX } from 'lucide-react';
 import strangerAmpsLogo from '@assets/stranger-amps-logo.png';
@@ -35,6 +36,15 @@ import { queryClient, apiRequest } from '@/lib/queryClient';
 import { audioEngine } from '@/lib/audioEngine';
 import { defaultAmpSettings, builtInIRs, type AmpSettings, type Preset } from '@shared/schema';
 
+// Scope points kept on screen, about 170 ms at the plugin's scope rate
+const scopeLength = 512;
+
+// Linear peak to the 0-100 meter scale, covering -60 to 0 dBFS
+function peakToMeterLevel(peak: number): number {
+  const db = 20 * Math.log10(Math.max(peak, 1e-6));
+  return Math.max(0, Math.min(100, ((db + 60) / 60) * 100));
+}
+
 export default function AmpSimulator() {
   const { toast } = useToast();
   const [settings, setSettings] = useState<AmpSettings>(defaultAmpSettings);
@@ -44,6 +54,10 @@ export default function AmpSimulator() {
   const [isMuted, setIsMuted] = useState(false);
   const [isAudioConnected, setIsAudioConnected] = useState(false);
   const [isOptimizing, setIsOptimizing] = useState(false);
+  const [irOptions, setIROptions] = useState<CustomIROptions>({ minimumPhase: false });
+  const [irReport, setIRReport] = useState<CustomIRReport | null>(null);
+  const [scope, setScope] = useState<Float32Array | undefined>();
+  const scopeTraceRef = useRef(new Float32Array(scopeLength));
   const animationRef = useRef<number>();
   const isJUCE = isJUCEPlugin();
 
@@ -117,6 +131,12 @@ export default function AmpSimulator() {
     setCurrentPreset(null);
   }, [isJUCE]);
 
+  // Native imports only; the plugin re-imports the current IR with them
+  const handleIROptionsChange = useCallback((options: CustomIROptions) => {
+    setIROptions(options);
+    setCustomIROptionsInJUCE(options);
+  }, []);
+
   const handlePresetChange = useCallback((preset: Preset) => {
     setCurrentPreset(preset);
     const mergedSettings = { ...defaultAmpSettings, ...preset.settings };
@@ -170,7 +190,22 @@ export default function AmpSimulator() {
     });
   }, [settings.aiTuning, handleSettingsChange, toast]);
 
+  // Inside the plugin, meters and scope follow the native meter frames
+  const handleMeterFrame = useCallback((frame: MeterFrame) => {
+    setInputLevel(peakToMeterLevel(frame.input.peak));
+    setIsClipping(frame.input.peak >= 1 || frame.output.peak >= 1);
+
+    // Scroll the newest points in from the right
+    const trace = scopeTraceRef.current;
+    const count = Math.min(frame.scope.length, trace.length);
+    trace.copyWithin(0, count);
+    trace.set(frame.scope.subarray(frame.scope.length - count), trace.length - count);
+    setScope(trace.slice());
+  }, []);
+
   useEffect(() => {
+    if (isJUCE) return;
+
     const updateLevel = () => {
       if (isAudioConnected) {
         const level = audioEngine.getInputLevel();
@@ -199,7 +234,7 @@ export default function AmpSimulator() {
         cancelAnimationFrame(animationRef.current);
       }
     };
-  }, [settings.inputGain, settings.drive, settings.punish, settings.plus10db, isAudioConnected]);
+  }, [settings.inputGain, settings.drive, settings.punish, settings.plus10db, isAudioConnected, isJUCE]);
 
   // Initialize JUCE bridge
   useEffect(() => {
@@ -224,7 +259,24 @@ export default function AmpSimulator() {
             setSettings(presetData.settings);
             audioEngine.updateSettings(presetData.settings);
           }
-        }
+        },
+        (report: CustomIRReport) => {
+          if (report.error) {
+            toast({
+              title: 'IR Load Failed',
+              description: report.error,
+              variant: 'destructive',
+            });
+          }
+
+          // The IR that plays, which a failed load leaves in place
+          if (report.name) {
+            setIRReport(report);
+            setIROptions(report.options);
+            setSettings((prev) => ({ ...prev, customIRName: report.name }));
+          }
+        },
+        handleMeterFrame
       );
 
       return () => {
@@ -233,7 +285,7 @@ export default function AmpSimulator() {
     } else {
       console.log('[Stranger Amps] Running in web mode');
     }
-  }, [isJUCE]);
+  }, [isJUCE, toast, handleMeterFrame]);
 
   useEffect(() => {
     return () => {
@@ -400,7 +452,7 @@ export default function AmpSimulator() {
         </div>
 
         <div className="flex flex-col flex-1 max-w-2xl min-w-0">
-          <AmpHeadDisplay isClipping={isClipping} />
+          <AmpHeadDisplay isClipping={isClipping} scope={scope} />
           <Cabinet
             irName={settings.irBypass ? 'BYPASSED' : displayIRName}
             isActive={!settings.irBypass}
@@ -421,6 +473,10 @@ export default function AmpSimulator() {
                 });
               }
             }}
+            onBrowseCustomIR={isJUCE ? () => browseCustomIRInJUCE(irOptions) : undefined}
+            irOptions={isJUCE ? irOptions : undefined}
+            onIROptionsChange={isJUCE ? handleIROptionsChange : undefined}
+            irReport={irReport}
           />
         </div>
       </main>